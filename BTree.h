@@ -0,0 +1,1908 @@
+/**
+ * BTree: a B+tree index over any key and payload type.
+ *
+ * BTree<Key, Payload, Compare> maps keys ordered by Compare to payloads.
+ * Keys and payloads have a fixed size and are copied with memcpy. The
+ * node classes come from BTreeNodes<Key, Payload, Compare>. By default
+ * they are BTLeaf and BTNonLeaf, which store arrays of keys whose
+ * capacities are fixed at compile time from the size of the key, and
+ * search them with NodeSearch<Key, Compare>.
+ *
+ * BTreeIndex, the int index of Bruinbase, is BTree<int, RecordId> on the
+ * compressed BTLeafNode and the Eytzinger BTNonLeafNode (see BTreeIndex.h).
+ * IntPair and FixedKey<N> are the keys for composite (int, int) keys and
+ * fixed-length strings. 64-bit keys are plain long longs.
+ */
+
+#ifndef BTREE_H
+#define BTREE_H
+
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "PageFile.h"
+#include "BTreeNode.h"
+#include "KeySearch.h"
+
+/**
+ * The data structure to point to a particular entry at a b+tree leaf node.
+ * An IndexCursor consists of pid (PageId of the leaf node) and
+ * eid (the location of the index entry inside the node).
+ * IndexCursor is used for index lookup and traversal.
+ */
+typedef struct {
+  // PageId of the index entry
+  PageId  pid;
+  // The entry number inside the node
+  int     eid;
+} IndexCursor;
+
+/**
+ * IntPair: a composite key of two ints, ordered by first and then by second.
+ */
+struct IntPair {
+  int first;
+  int second;
+};
+
+inline bool operator<(const IntPair& a, const IntPair& b)
+{
+  return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+/**
+ * FixedKey: a string key of N bytes, padded with zeros and ordered
+ * byte by byte like strcmp.
+ */
+template<int N>
+struct FixedKey {
+  char bytes[N];
+
+  /**
+   * make a key from a string. longer strings are cut to N bytes.
+   * @param s[IN] the string
+   * @return the key
+   */
+  static FixedKey from(const std::string& s)
+  {
+    FixedKey key;
+    memset(key.bytes, 0, N);
+    memcpy(key.bytes, s.data(), s.size() < (size_t) N ? s.size() : N);
+    return key;
+  }
+};
+
+template<int N>
+inline bool operator<(const FixedKey<N>& a, const FixedKey<N>& b)
+{
+  return memcmp(a.bytes, b.bytes, N) < 0;
+}
+
+/**
+ * NodeSearch: the search kernel for the sorted keys of a node.
+ * The general one is a branch-free binary search with Compare. int keys
+ * in their natural order use the SIMD kernels of KeySearch.
+ */
+template<class Key, class Compare>
+struct NodeSearch {
+  // the number of keys smaller than key
+  static int countLess(const Key* keys, int count, const Key& key)
+  {
+    Compare less;
+    if (count == 0) return 0;
+    const Key* base = keys;
+    for (int n = count; n > 1; n -= n / 2)
+      base = less(base[n / 2], key) ? base + n / 2 : base;
+    return (base - keys) + less(*base, key);
+  }
+
+  // the number of keys not larger than key
+  static int countNotGreater(const Key* keys, int count, const Key& key)
+  {
+    Compare less;
+    if (count == 0) return 0;
+    const Key* base = keys;
+    for (int n = count; n > 1; n -= n / 2)
+      base = !less(key, base[n / 2]) ? base + n / 2 : base;
+    return (base - keys) + !less(key, *base);
+  }
+};
+
+template<>
+struct NodeSearch<int, std::less<int> > {
+  static int countLess(const int* keys, int count, int key)
+  {
+    return KeySearch::countLess(keys, count, 1, key);
+  }
+
+  static int countNotGreater(const int* keys, int count, int key)
+  {
+    return KeySearch::countNotGreater(keys, count, 1, key);
+  }
+};
+
+/**
+ * BTLeaf: a leaf node of a generic BTree.
+ * The page starts with the NodeHeader and the PageId of the next sibling
+ * node, followed by the keys of all entries and then by their payloads.
+ */
+template<class Key, class Payload, class Compare>
+class BTLeaf {
+ public:
+  // Maximum number of entries that a leaf node can have. 16 bytes are
+  // left for the alignment of the keys and the payloads.
+  static const int MAX_ENTRIES = (PageFile::PAGE_SIZE - sizeof(NodeHeader) - 2 * sizeof(PageId) - 16) / (sizeof(Key) + sizeof(Payload));
+
+  BTLeaf();
+
+  /**
+   * Insert the (key, payload) pair to the node, before the entries with the same key.
+   * @return 0 if successful. RC_NODE_FULL if the node is full.
+   */
+  RC insert(const Key& key, const Payload& payload);
+
+  /**
+   * Insert the (key, payload) pair to the node and split the node with
+   * sibling, as BTLeafNode::insertAndSplit() does.
+   * @param sibling[IN] the sibling node to split with. It MUST be EMPTY.
+   * @param siblingKey[OUT] the first key in the sibling node after split.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC insertAndSplit(const Key& key, const Payload& payload, BTLeaf& sibling, Key& siblingKey);
+
+  /**
+   * Insert the (key, payload) pair to the node and move entries between
+   * the node and its right sibling, so that both hold about half of them.
+   * @param sibling[IN/OUT] the next node under the same parent.
+   * @param siblingKey[OUT] the first key in the sibling node after the move.
+   * @return 0 if successful. RC_NODE_FULL if the entries do not fit in the two nodes.
+   */
+  RC insertAndRedistribute(const Key& key, const Payload& payload, BTLeaf& sibling, Key& siblingKey);
+
+  /**
+   * Fill the empty node with the first entries of a sorted list, as
+   * BTLeafNode::fill() does: fillPercent percent of MAX_ENTRIES, at least one.
+   * @param taken[OUT] the number of entries stored in the node
+   * @return 0 if successful. RC_INVALID_CURSOR if the node is not empty.
+   */
+  RC fill(const Key* allKeys, const Payload* allPayloads, int count, int fillPercent, int& taken);
+
+  /**
+   * Set eid to the entry of the largest key smaller than searchKey,
+   * or to -1 if there is no such key.
+   * @return RC_NO_SUCH_RECORD
+   */
+  RC locate(const Key& searchKey, int& eid);
+
+  /**
+   * Set eid to the last entry whose key is not larger than searchKey,
+   * or to -1 if there is no such key.
+   * @return 0
+   */
+  RC locateLast(const Key& searchKey, int& eid);
+
+  /**
+   * Read the (key, payload) pair from the eid entry.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC readEntry(int eid, Key& key, Payload& payload);
+
+  /**
+   * Remove the eid entry from the node, shifting the entries behind it.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC remove(int eid);
+
+  /**
+   * Change the payload of the eid entry.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC setPayload(int eid, const Payload& payload);
+
+  PageId getNextNodePtr() { return page.next; }
+  RC setNextNodePtr(PageId pid) { page.next = pid; return 0; }
+  PageId getPrevNodePtr() { return page.prev; }
+  RC setPrevNodePtr(PageId pid) { page.prev = pid; return 0; }
+  int getKeyCount() { return page.header.keyCount; }
+
+  /**
+   * Read the content of the node from the page pid in the PageFile pf.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC read(PageId pid, const PageFile& pf);
+
+  /**
+   * Write the content of the node to the page pid in the PageFile pf.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC write(PageId pid, PageFile& pf) { return pf.write(pid, buffer); }
+
+ private:
+  struct Page {
+    NodeHeader header;
+    PageId     next;
+    PageId     prev;
+    Key        keys[MAX_ENTRIES];
+    Payload    payloads[MAX_ENTRIES];
+  };
+  static_assert(sizeof(Page) <= PageFile::PAGE_SIZE, "a leaf must fit in a page");
+
+  // store count sorted entries in the node and sibling, split at split
+  void distribute(const Key* allKeys, const Payload* allPayloads, int count,
+                  int split, BTLeaf& sibling);
+
+  union {
+    char buffer[PageFile::PAGE_SIZE];
+    Page page;
+  };
+};
+
+/**
+ * BTNonLeaf: a nonleaf node of a generic BTree.
+ * The page starts with the NodeHeader, followed by the keys and then by
+ * the child PageIds. The i-th PageId points to the child left of the i-th
+ * key, and the one behind the last key to the right most child.
+ */
+template<class Key, class Compare>
+class BTNonLeaf {
+ public:
+  // Maximum number of keys that a nonleaf node can have. 16 bytes are
+  // left for the alignment of the keys.
+  static const int MAX_ENTRIES = (PageFile::PAGE_SIZE - sizeof(NodeHeader) - sizeof(PageId) - 16) / (sizeof(Key) + sizeof(PageId));
+
+  BTNonLeaf();
+
+  /**
+   * Insert a (key, pid) pair to the node. pid goes right of key, and
+   * right of the child left when other keys are equal to key.
+   * @return 0 if successful. RC_NODE_FULL if the node is full.
+   */
+  RC insert(const Key& key, PageId pid, PageId left);
+
+  /**
+   * Insert the (key, pid) pair to the node and split the node with
+   * sibling, as BTNonLeafNode::insertAndSplit() does.
+   * @param sibling[IN] the sibling node to split with. It MUST be empty.
+   * @param midKey[OUT] the key to insert to the parent node.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC insertAndSplit(const Key& key, PageId pid, PageId left, BTNonLeaf& sibling, Key& midKey);
+
+  /**
+   * Fill the empty node with the first children of a level of the tree,
+   * as BTNonLeafNode::fill() does.
+   * @param taken[OUT] the number of children stored in the node
+   * @return 0 if successful. RC_INVALID_CURSOR if the node is not empty.
+   */
+  RC fill(const Key* childKeys, const PageId* childPids, int count, int fillPercent, int& taken);
+
+  /**
+   * Find the child to follow for searchKey: the one left of the first key
+   * larger than searchKey.
+   * @return 0
+   */
+  RC locateChildPtr(const Key& searchKey, PageId& pid);
+
+  /**
+   * Find the child to follow for the first entry with searchKey: the one
+   * left of the first key not smaller than searchKey.
+   * @return 0
+   */
+  RC locateLeftChildPtr(const Key& searchKey, PageId& pid);
+
+  PageId getFirstChildPtr() { return page.pids[0]; }
+
+  /**
+   * Initialize the root node with (pid1, key, pid2).
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC initializeRoot(PageId pid1, const Key& key, PageId pid2);
+
+  /**
+   * Find the right neighbour of a child node and the key between the two.
+   * @return 0 if successful. RC_NO_SUCH_RECORD if pid is not a child of
+   * the node or is the right most one.
+   */
+  RC locateRightSibling(PageId pid, PageId& sibling, int& eid);
+
+  /**
+   * Change the key at position eid. The keys must stay sorted.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC setKey(int eid, const Key& key);
+
+  int getKeyCount() { return page.header.keyCount; }
+
+  /**
+   * Read the content of the node from the page pid in the PageFile pf.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC read(PageId pid, const PageFile& pf);
+
+  /**
+   * Write the content of the node to the page pid in the PageFile pf.
+   * @return 0 if successful. Return an error code if there is an error.
+   */
+  RC write(PageId pid, PageFile& pf) { return pf.write(pid, buffer); }
+
+ private:
+  struct Page {
+    NodeHeader header;
+    Key        keys[MAX_ENTRIES];
+    PageId     pids[MAX_ENTRIES + 1];
+  };
+  static_assert(sizeof(Page) <= PageFile::PAGE_SIZE, "a nonleaf node must fit in a page");
+  static_assert(MAX_ENTRIES >= 3, "a nonleaf node must hold three keys");
+
+  // return the position of a new key whose pid goes right of the child left
+  int insertPosition(const Key& key, PageId left);
+
+  union {
+    char buffer[PageFile::PAGE_SIZE];
+    Page page;
+  };
+};
+
+/**
+ * BTreeNodes: the node classes of a BTree.
+ */
+template<class Key, class Payload, class Compare>
+struct BTreeNodes {
+  typedef BTLeaf<Key, Payload, Compare> Leaf;
+  typedef BTNonLeaf<Key, Compare>       NonLeaf;
+};
+
+/**
+ * Implements a B-Tree index for bruinbase.
+ *
+ */
+template<class Key, class Payload, class Compare = std::less<Key> >
+class BTree {
+ public:
+  typedef typename BTreeNodes<Key, Payload, Compare>::Leaf    LeafNode;
+  typedef typename BTreeNodes<Key, Payload, Compare>::NonLeaf NonLeafNode;
+
+  BTree();
+
+  // pid value where we store treeHeight and our rootPid
+  static const int BTREE_BOOT_UP_PID = 0;
+
+  // how full bulkLoad() makes the nodes by default, as the 90/10 split
+  // of insert() does for keys in increasing order
+  static const int BULK_FILL_PERCENT = 90;
+
+  /**
+   * Open the index file in read or write mode.
+   * Under 'w' mode, the index file should be created if it does not exist.
+   * @param indexname[IN] the name of the index file
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @return error code. RC_INVALID_FILE_FORMAT if the nodes of the file
+   *         are not in the current format
+   */
+  RC open(const std::string& indexname, char mode);
+
+  /**
+   * Close the index file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * Insert (key, payload) pair to the index.
+   * @param key[IN] the key for the value inserted into the index
+   * @param payload[IN] the payload, e.g. the RecordId of the record being inserted
+   * @return error code. 0 if no error
+   */
+  RC insert(const Key& key, const Payload& payload);
+
+  /**
+   * Build the tree bottom up from a sorted list of (key, payload) pairs:
+   * fill the leaf nodes from left to right, then each level of nonleaf
+   * nodes above them, until one node is left for the root. Every node is
+   * written once, at the end of the file. The tree must be empty.
+   * @param keys[IN] the keys of the entries, sorted
+   * @param payloads[IN] the payloads of the entries, in the order of the
+   *                     entries of the same key in a leaf node
+   * @param count[IN] the number of entries
+   * @param fillPercent[IN] how full the nodes should be, from 1 to 100.
+   *                        the rest of a node is left for later inserts
+   * @return error code. 0 if no error
+   */
+  RC bulkLoad(const Key* keys, const Payload* payloads, int count,
+              int fillPercent = BULK_FILL_PERCENT);
+
+  /**
+   * Run the standard B+Tree key search algorithm and identify the
+   * leaf node where searchKey may exist. If an index entry with
+   * searchKey exists in the leaf node, set IndexCursor to its location
+   * (i.e., IndexCursor.pid = PageId of the leaf node, and
+   * IndexCursor.eid = the searchKey index entry number.) and return 0.
+   * If not, set IndexCursor.pid = PageId of the leaf node and
+   * IndexCursor.eid = the index entry immediately after the largest
+   * index key that is smaller than searchKey, and return the error
+   * code RC_NO_SUCH_RECORD.
+   * Using the returned "IndexCursor", you will have to call readForward()
+   * to retrieve the actual (key, payload) pair from the index.
+   * @param key[IN] the key to find
+   * @param cursor[OUT] the cursor pointing to the index entry with
+   *                    searchKey or immediately behind the largest key
+   *                    smaller than searchKey.
+   * @return 0 if searchKey is found. Othewise, an error code
+   */
+  RC locate(const Key& searchKey, IndexCursor& cursor);
+
+  /**
+   * Locate a batch of keys, e.g. of an IN list or a join, as locate()
+   * does for each of them. The keys are sorted first and walk down the
+   * tree together: a node is read once for all keys that pass through it,
+   * so every leaf node is read at most once.
+   * @param searchKeys[IN] the keys to find, in any order
+   * @param count[IN] the number of keys
+   * @param cursors[OUT] the cursor of each key, in the order of searchKeys
+   * @return error code. 0 if no error
+   */
+  RC locateMany(const Key* searchKeys, int count, IndexCursor* cursors);
+
+  /**
+   * Read the (key, payload) pair at the location specified by the index cursor,
+   * and move foward the cursor to the next entry.
+   * @param cursor[IN/OUT] the cursor pointing to an leaf-node index entry in the b+tree
+   * @param key[OUT] the key stored at the index cursor location
+   * @param payload[OUT] the payload stored at the index cursor location
+   * @return error code. 0 if no error
+   */
+  RC readForward(IndexCursor& cursor, Key& key, Payload& payload);
+
+  /**
+   * Set the cursor to the last index entry whose key is not larger than
+   * searchKey, to read the entries from there on with readBackward().
+   * With the largest key, the cursor is at the right edge of the tree.
+   * @param searchKey[IN] the key to find
+   * @param cursor[OUT] the cursor pointing to the last entry with a key
+   *                    not larger than searchKey
+   * @return error code. 0 if no error
+   */
+  RC locateBackward(const Key& searchKey, IndexCursor& cursor);
+
+  /**
+   * Read the (key, payload) pair at the location specified by the index
+   * cursor, and move the cursor back to the previous entry.
+   * @param cursor[IN/OUT] the cursor pointing to an leaf-node index entry in the b+tree
+   * @param key[OUT] the key stored at the index cursor location
+   * @param payload[OUT] the payload stored at the index cursor location
+   * @return error code. RC_END_OF_TREE if there is no entry left
+   */
+  RC readBackward(IndexCursor& cursor, Key& key, Payload& payload);
+
+  /**
+   * @param count[OUT] total number of keys in the BTree
+   * @return error code. 0 if no error
+   */
+  RC getTotalKeyCount(int& count);
+
+  /**
+   * Remove the (key, payload) pair from the index.
+   * The leaf node is not merged with its siblings even if it becomes
+   * empty; readForward() skips empty leaf nodes.
+   * @param key[IN] the key of the entry to remove
+   * @param payload[IN] the payload of the entry to remove
+   * @return error code. RC_NO_SUCH_RECORD if there is no such entry
+   */
+  RC remove(const Key& key, const Payload& payload);
+
+  /**
+   * Point the (key, oldPayload) entry of the index to newPayload,
+   * e.g. for a record that was moved to another slot.
+   * @param key[IN] the key of the entry
+   * @param oldPayload[IN] the payload stored in the entry
+   * @param newPayload[IN] the new payload of the entry
+   * @return error code. RC_NO_SUCH_RECORD if there is no such entry
+   */
+  RC replace(const Key& key, const Payload& oldPayload, const Payload& newPayload);
+
+ private:
+  /**
+   * Find the leaf node entry with the (key, payload) pair.
+   * @param key[IN] the key of the entry
+   * @param payload[IN] the payload of the entry
+   * @param cursor[OUT] the location of the entry
+   * @return error code. RC_NO_SUCH_RECORD if there is no such entry
+   */
+  RC findEntry(const Key& key, const Payload& payload, IndexCursor& cursor);
+
+  /**
+   * Keep the right most leaf node in memory for the next insert().
+   * @param leaf[IN] the right most leaf node, as written to the disk
+   * @param pid[IN] the PageId of the node
+   * @param path[IN] the nonleaf nodes above it, from the root down
+   */
+  void keepLastLeaf(const LeafNode& leaf, PageId pid, const std::vector<PageId>& path);
+
+  template<class K, class P, class C> friend class BTreeCursor;
+
+  PageFile pf;         /// the PageFile used to store the actual b+tree in disk
+
+  PageId   rootPid;    /// the PageId of the root node
+  int      treeHeight; /// the height of the tree
+  /// Note that the content of the above two variables will be gone when
+  /// this class is destructed. Make sure to store the values of the two
+  /// variables in disk, so that they can be reconstructed when the index
+  /// is opened again later.
+  char buffer[PageFile::PAGE_SIZE];
+
+  /// the right most leaf node, kept by insert() for keys in increasing
+  /// order. any other change of the tree drops it.
+  LeafNode lastLeaf;
+  PageId   lastLeafPid; /// the PageId of lastLeaf. 0 if it is not kept
+  Key      lastLeafLow; /// the first key of lastLeaf
+  std::vector<PageId> rightPath; /// the nonleaf nodes above lastLeaf
+};
+
+/**
+ * BTreeCursor: reads the entries of a BTree in key order, like
+ * readForward() with an IndexCursor, but keeps the leaf node it is in.
+ * The entries of the leaf are read from the node in memory, and the next
+ * leaf is only read when the cursor moves past the last entry.
+ * The tree must not be changed while the cursor is in use.
+ */
+template<class Key, class Payload, class Compare = std::less<Key> >
+class BTreeCursor {
+ public:
+  typedef BTree<Key, Payload, Compare> Tree;
+
+  BTreeCursor();
+
+  /**
+   * Position the cursor at the first entry of tree whose key is not
+   * smaller than searchKey, and read the leaf node of the entry.
+   * @param tree[IN] the open tree to read
+   * @param searchKey[IN] the key to find
+   * @return error code. 0 if no error
+   */
+  RC locate(Tree& tree, const Key& searchKey);
+
+  /**
+   * Read the entry at the cursor and move the cursor to the next entry.
+   * @param key[OUT] the key of the entry
+   * @param payload[OUT] the payload of the entry
+   * @return error code. RC_END_OF_TREE if there is no entry left
+   */
+  RC next(Key& key, Payload& payload);
+
+  /**
+   * Read up to n entries from the cursor on and move the cursor behind
+   * them. The entries come from one leaf node: a batch stops at the end
+   * of the leaf, so the next leaf is only read by the next call.
+   * @param n[IN] the most entries to read
+   * @param keys[OUT] the keys of the entries
+   * @param payloads[OUT] the payloads of the entries
+   * @param count[OUT] the number of entries read
+   * @return error code. RC_END_OF_TREE if there is no entry left
+   */
+  RC next(int n, Key* keys, Payload* payloads, int& count);
+
+ private:
+  // move on to the next leaf while the cursor is behind the last entry of its leaf
+  RC advance();
+
+  typename Tree::LeafNode leaf;  // the leaf node the cursor is in
+  const PageFile* pf;            // the PageFile of the tree
+  PageId pid;                    // the PageId of leaf. 0 behind the last leaf
+  int    eid;                    // the entry of leaf the cursor is at
+};
+
+/*
+ * Check the header of a generic node read from the disk.
+ * @return 0 if the node has the given type, key size and the current format.
+ */
+inline RC checkGenericHeader(const NodeHeader& header, int type, int keySize)
+{
+	if (header.version != NodeHeader::VERSION || header.type != type ||
+	    header.flags != keySize)
+		return RC_INVALID_FILE_FORMAT;
+	return 0;
+}
+
+// START: BTLeaf
+
+template<class Key, class Payload, class Compare>
+BTLeaf<Key, Payload, Compare>::BTLeaf()
+{
+	memset(buffer, 0, PageFile::PAGE_SIZE);
+	page.header.version = NodeHeader::VERSION;
+	page.header.type = NodeHeader::GENERIC_LEAF;
+	page.header.flags = sizeof(Key);
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::read(PageId pid, const PageFile& pf)
+{
+	RC errorMsg = pf.read(pid, buffer);
+	if (errorMsg != 0)
+		return errorMsg;
+	return checkGenericHeader(page.header, NodeHeader::GENERIC_LEAF, sizeof(Key));
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::insert(const Key& key, const Payload& payload)
+{
+	int count = getKeyCount();
+	if (count >= MAX_ENTRIES)
+		return RC_NODE_FULL;
+
+	// shift the entries behind the new one to the right
+	int pos = NodeSearch<Key, Compare>::countLess(page.keys, count, key);
+	memmove(page.keys + pos + 1, page.keys + pos, (count - pos) * sizeof(Key));
+	memmove(page.payloads + pos + 1, page.payloads + pos, (count - pos) * sizeof(Payload));
+	page.keys[pos] = key;
+	page.payloads[pos] = payload;
+	page.header.keyCount = count + 1;
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::insertAndSplit(const Key& key, const Payload& payload,
+                                                 BTLeaf& sibling, Key& siblingKey)
+{
+	int oldKeyCount = getKeyCount();
+	if (oldKeyCount < MAX_ENTRIES)
+		return RC_INVALID_CURSOR; // node is not full, does not need to be split
+	if (sibling.getKeyCount() != 0)
+		return RC_INVALID_CURSOR; // sibling node must be empty
+
+	// put all entries, the new one included, in one sorted list
+	int count = oldKeyCount + 1;
+	int pos = NodeSearch<Key, Compare>::countLess(page.keys, oldKeyCount, key);
+	Key allKeys[MAX_ENTRIES + 1];
+	Payload allPayloads[MAX_ENTRIES + 1];
+	memcpy(allKeys, page.keys, pos * sizeof(Key));
+	memcpy(allPayloads, page.payloads, pos * sizeof(Payload));
+	allKeys[pos] = key;
+	allPayloads[pos] = payload;
+	memcpy(allKeys + pos + 1, page.keys + pos, (oldKeyCount - pos) * sizeof(Key));
+	memcpy(allPayloads + pos + 1, page.payloads + pos, (oldKeyCount - pos) * sizeof(Payload));
+
+	distribute(allKeys, allPayloads, count, nodeSplitPoint(count, pos), sibling);
+	sibling.setNextNodePtr(getNextNodePtr());
+	// current node's nextPointer needs to be set in the function that calls this during sibling node creation
+
+	siblingKey = sibling.page.keys[0];
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::insertAndRedistribute(const Key& key, const Payload& payload,
+                                                        BTLeaf& sibling, Key& siblingKey)
+{
+	int oldKeyCount = getKeyCount();
+	int siblingKeyCount = sibling.getKeyCount();
+	int count = oldKeyCount + 1 + siblingKeyCount;
+	if (count > 2 * MAX_ENTRIES)
+		return RC_NODE_FULL;
+
+	// put the entries of both nodes and the new one in one sorted list
+	int pos = NodeSearch<Key, Compare>::countLess(page.keys, oldKeyCount, key);
+	Key allKeys[2 * MAX_ENTRIES];
+	Payload allPayloads[2 * MAX_ENTRIES];
+	memcpy(allKeys, page.keys, pos * sizeof(Key));
+	memcpy(allPayloads, page.payloads, pos * sizeof(Payload));
+	allKeys[pos] = key;
+	allPayloads[pos] = payload;
+	memcpy(allKeys + pos + 1, page.keys + pos, (oldKeyCount - pos) * sizeof(Key));
+	memcpy(allPayloads + pos + 1, page.payloads + pos, (oldKeyCount - pos) * sizeof(Payload));
+	memcpy(allKeys + oldKeyCount + 1, sibling.page.keys, siblingKeyCount * sizeof(Key));
+	memcpy(allPayloads + oldKeyCount + 1, sibling.page.payloads, siblingKeyCount * sizeof(Payload));
+
+	distribute(allKeys, allPayloads, count, count / 2, sibling);
+	siblingKey = sibling.page.keys[0];
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::fill(const Key* allKeys, const Payload* allPayloads,
+                                       int count, int fillPercent, int& taken)
+{
+	if (getKeyCount() != 0 || count < 1)
+		return RC_INVALID_CURSOR;
+	taken = std::min(count, std::max(1, MAX_ENTRIES * fillPercent / 100));
+	memcpy(page.keys, allKeys, taken * sizeof(Key));
+	memcpy(page.payloads, allPayloads, taken * sizeof(Payload));
+	page.header.keyCount = taken;
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+void BTLeaf<Key, Payload, Compare>::distribute(const Key* allKeys, const Payload* allPayloads,
+                                               int count, int split, BTLeaf& sibling)
+{
+	memcpy(page.keys, allKeys, split * sizeof(Key));
+	memcpy(page.payloads, allPayloads, split * sizeof(Payload));
+	memcpy(sibling.page.keys, allKeys + split, (count - split) * sizeof(Key));
+	memcpy(sibling.page.payloads, allPayloads + split, (count - split) * sizeof(Payload));
+	page.header.keyCount = split;
+	sibling.page.header.keyCount = count - split;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::locate(const Key& searchKey, int& eid)
+{
+	eid = NodeSearch<Key, Compare>::countLess(page.keys, getKeyCount(), searchKey) - 1;
+	return RC_NO_SUCH_RECORD;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::locateLast(const Key& searchKey, int& eid)
+{
+	eid = NodeSearch<Key, Compare>::countNotGreater(page.keys, getKeyCount(), searchKey) - 1;
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::readEntry(int eid, Key& key, Payload& payload)
+{
+	if (eid < 0 || eid >= getKeyCount())
+		return RC_INVALID_CURSOR;
+
+	key = page.keys[eid];
+	payload = page.payloads[eid];
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::remove(int eid)
+{
+	int count = getKeyCount();
+	if (eid < 0 || eid >= count)
+		return RC_INVALID_CURSOR;
+
+	memmove(page.keys + eid, page.keys + eid + 1, (count - eid - 1) * sizeof(Key));
+	memmove(page.payloads + eid, page.payloads + eid + 1, (count - eid - 1) * sizeof(Payload));
+	page.header.keyCount = count - 1;
+	return 0;
+}
+
+template<class Key, class Payload, class Compare>
+RC BTLeaf<Key, Payload, Compare>::setPayload(int eid, const Payload& payload)
+{
+	if (eid < 0 || eid >= getKeyCount())
+		return RC_INVALID_CURSOR;
+
+	page.payloads[eid] = payload;
+	return 0;
+}
+
+// START: BTNonLeaf
+
+template<class Key, class Compare>
+BTNonLeaf<Key, Compare>::BTNonLeaf()
+{
+	memset(buffer, 0, PageFile::PAGE_SIZE);
+	page.header.version = NodeHeader::VERSION;
+	page.header.type = NodeHeader::GENERIC_NON_LEAF;
+	page.header.flags = sizeof(Key);
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::read(PageId pid, const PageFile& pf)
+{
+	RC errorMsg = pf.read(pid, buffer);
+	if (errorMsg != 0)
+		return errorMsg;
+	return checkGenericHeader(page.header, NodeHeader::GENERIC_NON_LEAF, sizeof(Key));
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::insert(const Key& key, PageId pid, PageId left)
+{
+	int count = getKeyCount();
+	if (count >= MAX_ENTRIES)
+		return RC_NODE_FULL;
+
+	// the first key of initializeRoot() brings the left most pid along.
+	// otherwise the new pid goes right of the new key.
+	if (count == 0)
+	{
+		page.keys[0] = key;
+		page.pids[0] = pid;
+	}
+	else
+	{
+		int pos = insertPosition(key, left);
+		memmove(page.keys + pos + 1, page.keys + pos, (count - pos) * sizeof(Key));
+		memmove(page.pids + pos + 2, page.pids + pos + 1, (count - pos) * sizeof(PageId));
+		page.keys[pos] = key;
+		page.pids[pos + 1] = pid;
+	}
+	page.header.keyCount = count + 1;
+	return 0;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::insertAndSplit(const Key& key, PageId pid, PageId left, BTNonLeaf& sibling, Key& midKey)
+{
+	int oldKeyCount = getKeyCount();
+	if (oldKeyCount < MAX_ENTRIES)
+		return RC_INVALID_CURSOR; // node is not full, does not need to be split
+	if (sibling.getKeyCount() != 0)
+		return RC_INVALID_CURSOR; // sibling node must be empty
+
+	// put all keys and pids, the new ones included, in one sorted list
+	int count = oldKeyCount + 1;
+	int pos = insertPosition(key, left);
+	Key allKeys[MAX_ENTRIES + 1];
+	PageId allPids[MAX_ENTRIES + 2];
+	memcpy(allKeys, page.keys, pos * sizeof(Key));
+	memcpy(allPids, page.pids, (pos + 1) * sizeof(PageId));
+	allKeys[pos] = key;
+	allPids[pos + 1] = pid;
+	memcpy(allKeys + pos + 1, page.keys + pos, (oldKeyCount - pos) * sizeof(Key));
+	memcpy(allPids + pos + 2, page.pids + pos + 1, (oldKeyCount - pos) * sizeof(PageId));
+
+	// the middle key moves up to the parent node
+	int newKeyCount = std::min(nodeSplitPoint(count, pos), count - 2);
+	int siblingKeyCount = count - newKeyCount - 1;
+	memcpy(page.keys, allKeys, newKeyCount * sizeof(Key));
+	memcpy(page.pids, allPids, (newKeyCount + 1) * sizeof(PageId));
+	memcpy(sibling.page.keys, allKeys + newKeyCount + 1, siblingKeyCount * sizeof(Key));
+	memcpy(sibling.page.pids, allPids + newKeyCount + 1, (siblingKeyCount + 1) * sizeof(PageId));
+	page.header.keyCount = newKeyCount;
+	sibling.page.header.keyCount = siblingKeyCount;
+	midKey = allKeys[newKeyCount];
+	return 0;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::fill(const Key* childKeys, const PageId* childPids,
+                                 int count, int fillPercent, int& taken)
+{
+	if (getKeyCount() != 0 || count < 2)
+		return RC_INVALID_CURSOR;
+	taken = nodeFillCount(count, MAX_ENTRIES, fillPercent);
+	memcpy(page.keys, childKeys + 1, (taken - 1) * sizeof(Key));
+	memcpy(page.pids, childPids, taken * sizeof(PageId));
+	page.header.keyCount = taken - 1;
+	return 0;
+}
+
+template<class Key, class Compare>
+int BTNonLeaf<Key, Compare>::insertPosition(const Key& key, PageId left)
+{
+	// the children between keys equal to key may hold key as well
+	int count = getKeyCount();
+	int pos = NodeSearch<Key, Compare>::countLess(page.keys, count, key);
+	int last = NodeSearch<Key, Compare>::countNotGreater(page.keys, count, key);
+	while (pos < last && page.pids[pos] != left)
+		pos++;
+	return pos;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::locateChildPtr(const Key& searchKey, PageId& pid)
+{
+	pid = page.pids[NodeSearch<Key, Compare>::countNotGreater(page.keys, getKeyCount(), searchKey)];
+	return 0;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::locateLeftChildPtr(const Key& searchKey, PageId& pid)
+{
+	pid = page.pids[NodeSearch<Key, Compare>::countLess(page.keys, getKeyCount(), searchKey)];
+	return 0;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::initializeRoot(PageId pid1, const Key& key, PageId pid2)
+{
+	if (getKeyCount() != 0)
+		return RC_INVALID_CURSOR;
+	insert(key, pid1, pid1);
+	page.pids[1] = pid2;
+	return 0;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::locateRightSibling(PageId pid, PageId& sibling, int& eid)
+{
+	for (int i = 0; i < getKeyCount(); i++)
+	{
+		if (page.pids[i] == pid)
+		{
+			sibling = page.pids[i + 1];
+			eid = i;
+			return 0;
+		}
+	}
+	return RC_NO_SUCH_RECORD;
+}
+
+template<class Key, class Compare>
+RC BTNonLeaf<Key, Compare>::setKey(int eid, const Key& key)
+{
+	if (eid < 0 || eid >= getKeyCount())
+		return RC_INVALID_CURSOR;
+	page.keys[eid] = key;
+	return 0;
+}
+
+// START: BTree
+
+/*
+ * BTree constructor
+ */
+template<class Key, class Payload, class Compare>
+BTree<Key, Payload, Compare>::BTree()
+{
+    rootPid = -1;
+    treeHeight = 0;
+    lastLeafPid = 0;
+}
+
+/*
+ * Open the index file in read or write mode.
+ * Under 'w' mode, the index file should be created if it does not exist.
+ * @param indexname[IN] the name of the index file
+ * @param mode[IN] 'r' for read, 'w' for write
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::open(const std::string& indexname, char mode)
+{
+	RC errorMsg = pf.open(indexname, mode);
+	if (errorMsg != 0)
+		return errorMsg;
+	lastLeafPid = 0;
+
+	// check if our PageFile is empty
+	if (pf.endPid() == 0)
+	{
+		// store our default values to populate first pid in PageFile
+		memcpy(buffer, &rootPid, sizeof(PageId));
+		memcpy(buffer+sizeof(PageId), &treeHeight, sizeof(int));
+		errorMsg = pf.write(BTREE_BOOT_UP_PID, buffer);
+		if (errorMsg != 0)
+			return errorMsg;
+		return 0;
+	}
+	// otherwise read the content from disk
+	errorMsg = pf.read(BTREE_BOOT_UP_PID, buffer);
+	if (errorMsg != 0)
+		return errorMsg;
+	memcpy(&rootPid, buffer, sizeof(PageId));
+	memcpy(&treeHeight, buffer+sizeof(PageId), sizeof(int));
+
+	// an index written in an older node format cannot be read. the header
+	// of the root node tells, so the file is refused here rather than at
+	// the first lookup.
+	if (treeHeight == 1)
+	{
+		LeafNode root;
+		errorMsg = root.read(rootPid, pf);
+	}
+	else if (treeHeight > 1)
+	{
+		NonLeafNode root;
+		errorMsg = root.read(rootPid, pf);
+	}
+	if (errorMsg != 0)
+	{
+		pf.close();
+		rootPid = -1;
+		treeHeight = 0;
+	}
+	return errorMsg;
+}
+
+/*
+ * Close the index file.
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::close()
+{
+	// save our values to disk before closing if they have changed.
+	// buffer still holds the values read or written at open().
+	PageId oldRootPid;
+	int oldTreeHeight;
+	memcpy(&oldRootPid, buffer, sizeof(PageId));
+	memcpy(&oldTreeHeight, buffer+sizeof(PageId), sizeof(int));
+	if (oldRootPid != rootPid || oldTreeHeight != treeHeight)
+	{
+		memcpy(buffer, &rootPid, sizeof(PageId));
+		memcpy(buffer+sizeof(PageId), &treeHeight, sizeof(int));
+		RC errorMsg = pf.write(BTREE_BOOT_UP_PID, buffer);
+		if (errorMsg != 0)
+			return errorMsg;
+	}
+	return pf.close();
+}
+
+/*
+ * Insert (key, payload) pair to the index.
+ * A key not smaller than the first key of the right most leaf node goes
+ * to that node, which is kept in memory with the path to it: keys that
+ * arrive in increasing order are added without reading the tree, and only
+ * a split of the node updates its parent.
+ * @param key[IN] the key for the value inserted into the index
+ * @param payload[IN] the payload of the entry
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::insert(const Key& key, const Payload& payload)
+{
+	if (treeHeight == 0)
+	{
+		LeafNode first = LeafNode();
+		first.insert(key, payload);
+		rootPid = pf.endPid();
+		RC errorMsg = first.write(rootPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+		treeHeight++;
+		return 0;
+	}
+
+	Compare less;
+	bool toLastLeaf = (lastLeafPid > 0 && !less(key, lastLeafLow));
+	if (toLastLeaf && lastLeaf.insert(key, payload) != RC_NODE_FULL)
+		return lastLeaf.write(lastLeafPid, pf);
+
+	LeafNode leafNode;
+	PageId readPid;
+	std::vector<PageId> pids;	// used to find parent pids in the event of splits
+
+	if (toLastLeaf)
+	{
+		// the right most leaf node is split below
+		leafNode = lastLeaf;
+		readPid = lastLeafPid;
+		pids = rightPath;
+	}
+	else
+	{
+		NonLeafNode nonLeafNode;
+		readPid = rootPid;
+		int height = treeHeight;
+		// processing non-leaf nodes
+		while (height > 1)
+		{
+			// read the node from Pagefile
+			RC nonLeafRC = nonLeafNode.read(readPid, pf);
+
+			// if read error, return the error code
+			if (nonLeafRC != 0)
+				return nonLeafRC;
+
+			// save the parent pid in case of a node split
+			pids.push_back(readPid);
+
+			// locate the next node that we have to examine
+			nonLeafRC = nonLeafNode.locateChildPtr(key, readPid);
+			// if locate fails, return the error code
+			if (nonLeafRC != 0)
+				return nonLeafRC;
+
+			// examine the next level of the tree
+			height--;
+		}
+
+		// if we reached here, we have gotten to our leaf node
+		// read the node from Pagefile
+		RC leafRC = leafNode.read(readPid, pf);
+
+		// if read error, return the error code
+		if (leafRC != 0)
+			return leafRC;
+
+		if (leafNode.insert(key, payload) != RC_NODE_FULL)
+		{
+			leafRC = leafNode.write(readPid, pf);
+			if (leafRC == 0 && leafNode.getNextNodePtr() == 0)
+				keepLastLeaf(leafNode, readPid, pids);
+			return leafRC;
+		}
+	}
+	// the split may change any node on the right most path
+	lastLeafPid = 0;
+
+	// create new sibling node
+	LeafNode sibling;
+	Key siblingKey;
+	RC errorMsg;
+
+	// if the next node under the same parent has room to spare, it takes
+	// entries from this node instead of a split. nodes are fuller this way
+	// when keys arrive in random order.
+	if (!pids.empty())
+	{
+		NonLeafNode parent;
+		PageId siblingPid;
+		int eid;
+
+		errorMsg = parent.read(pids.back(), pf);
+		if (errorMsg != 0)
+			return errorMsg;
+		if (parent.locateRightSibling(readPid, siblingPid, eid) == 0)
+		{
+			errorMsg = sibling.read(siblingPid, pf);
+			if (errorMsg != 0)
+				return errorMsg;
+			if (sibling.getKeyCount() < leafNode.getKeyCount() &&
+			    leafNode.insertAndRedistribute(key, payload, sibling, siblingKey) == 0)
+			{
+				if ((errorMsg = parent.setKey(eid, siblingKey)) != 0 ||
+				    (errorMsg = leafNode.write(readPid, pf)) != 0 ||
+				    (errorMsg = sibling.write(siblingPid, pf)) != 0)
+					return errorMsg;
+				return parent.write(pids.back(), pf);
+			}
+			sibling = LeafNode();
+		}
+	}
+
+	errorMsg = leafNode.insertAndSplit(key, payload, sibling, siblingKey);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	// link the new sibling in between the node and its next node
+	PageId siblingPid = pf.endPid();
+	PageId nextPid = sibling.getNextNodePtr();
+	leafNode.setNextNodePtr(siblingPid);
+	sibling.setPrevNodePtr(readPid);
+
+	// save updated node in memory
+	errorMsg = leafNode.write(readPid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	// save new node in memory
+	errorMsg = sibling.write(siblingPid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	// the next node points back to the new sibling
+	if (nextPid > 0)
+	{
+		LeafNode next;
+		if ((errorMsg = next.read(nextPid, pf)) != 0 ||
+		    (errorMsg = next.setPrevNodePtr(siblingPid)) != 0 ||
+		    (errorMsg = next.write(nextPid, pf)) != 0)
+			return errorMsg;
+	}
+
+	Key newKey = siblingKey;
+	PageId splitPid = readPid;	// the node the new one was split from
+	// continually try to insert into parent non-leaf nodes and split if overflow
+	while (!pids.empty())
+	{
+		NonLeafNode parent;
+
+		// read the node from Pagefile
+		PageId parentPid = pids.back();
+		pids.pop_back();
+		errorMsg = parent.read(parentPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		if (parent.insert(newKey, pf.endPid()-1, splitPid) != RC_NODE_FULL)
+		{
+			errorMsg = parent.write(parentPid, pf);
+			// the new sibling of the right most leaf node takes its place
+			// under the same parent
+			if (errorMsg == 0 && splitPid == readPid && nextPid == 0)
+			{
+				pids.push_back(parentPid);
+				keepLastLeaf(sibling, siblingPid, pids);
+			}
+			return errorMsg;
+		}
+
+		NonLeafNode nonLeafSibling;
+		Key midKey;
+
+		errorMsg = parent.insertAndSplit(newKey, pf.endPid()-1, splitPid, nonLeafSibling, midKey);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		// save updated node in memory
+		errorMsg = parent.write(parentPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		// save new node in memory
+		errorMsg = nonLeafSibling.write(pf.endPid(), pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		newKey = midKey;
+		splitPid = parentPid;
+	}
+	// if we got here, we've overflowed the root node as well
+	NonLeafNode newRoot;
+	errorMsg = newRoot.initializeRoot(rootPid, newKey, pf.endPid()-1);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	rootPid = pf.endPid();
+	errorMsg = newRoot.write(pf.endPid(), pf);
+	if (errorMsg != 0)
+		return errorMsg;
+	treeHeight++;
+    return 0;
+}
+
+/*
+ * Keep the right most leaf node in memory for the next insert(). Keys not
+ * smaller than its first key are not smaller than any key of the nonleaf
+ * nodes above it, so they all go to this node.
+ * @param leaf[IN] the right most leaf node, as written to the disk
+ * @param pid[IN] the PageId of the node
+ * @param path[IN] the nonleaf nodes above it, from the root down
+ */
+template<class Key, class Payload, class Compare>
+void BTree<Key, Payload, Compare>::keepLastLeaf(const LeafNode& leaf, PageId pid,
+                                                const std::vector<PageId>& path)
+{
+	Payload payload;
+	lastLeaf = leaf;
+	lastLeafPid = (lastLeaf.readEntry(0, lastLeafLow, payload) == 0) ? pid : 0;
+	rightPath = path;
+}
+
+/*
+ * Build the tree bottom up from a sorted list of (key, payload) pairs.
+ * The leaf nodes take the pages behind the boot page one after the other,
+ * so each one knows its neighbours before it is written. The first key
+ * and the PageId of every node of a level make the children of the level
+ * above it.
+ * @param keys[IN] the keys of the entries, sorted
+ * @param payloads[IN] the payloads of the entries
+ * @param count[IN] the number of entries
+ * @param fillPercent[IN] how full the nodes should be, from 1 to 100
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::bulkLoad(const Key* keys, const Payload* payloads,
+                                          int count, int fillPercent)
+{
+	if (treeHeight != 0)
+		return RC_INVALID_FILE_MODE;
+	if (fillPercent < 1 || fillPercent > 100)
+		return RC_INVALID_ATTRIBUTE;
+	if (count == 0)
+		return 0;
+
+	std::vector<Key> levelKeys;
+	std::vector<PageId> levelPids;
+	RC errorMsg;
+
+	// the leaf level
+	PageId prevPid = 0;
+	for (int done = 0; done < count; )
+	{
+		LeafNode leaf;
+		PageId leafPid = pf.endPid();
+		int taken;
+
+		if ((errorMsg = leaf.fill(keys + done, payloads + done, count - done,
+		                          fillPercent, taken)) != 0)
+			return errorMsg;
+		leaf.setPrevNodePtr(prevPid);
+		leaf.setNextNodePtr(done + taken < count ? leafPid + 1 : 0);
+		if ((errorMsg = leaf.write(leafPid, pf)) != 0)
+			return errorMsg;
+
+		levelKeys.push_back(keys[done]);
+		levelPids.push_back(leafPid);
+		prevPid = leafPid;
+		done += taken;
+	}
+	treeHeight = 1;
+
+	// the nonleaf levels, until the root
+	while (levelPids.size() > 1)
+	{
+		std::vector<Key> parentKeys;
+		std::vector<PageId> parentPids;
+		int children = levelPids.size();
+
+		for (int done = 0; done < children; )
+		{
+			NonLeafNode node;
+			PageId nodePid = pf.endPid();
+			int taken;
+
+			if ((errorMsg = node.fill(&levelKeys[done], &levelPids[done], children - done,
+			                          fillPercent, taken)) != 0 ||
+			    (errorMsg = node.write(nodePid, pf)) != 0)
+				return errorMsg;
+
+			parentKeys.push_back(levelKeys[done]);
+			parentPids.push_back(nodePid);
+			done += taken;
+		}
+		levelKeys.swap(parentKeys);
+		levelPids.swap(parentPids);
+		treeHeight++;
+	}
+	rootPid = levelPids[0];
+	return 0;
+}
+
+/**
+ * Run the standard B+Tree key search algorithm and identify the
+ * leaf node where searchKey may exist. If an index entry with
+ * searchKey exists in the leaf node, set IndexCursor to its location
+ * (i.e., IndexCursor.pid = PageId of the leaf node, and
+ * IndexCursor.eid = the searchKey index entry number.) and return 0.
+ * If not, set IndexCursor.pid = PageId of the leaf node and
+ * IndexCursor.eid = the index entry immediately after the largest
+ * index key that is smaller than searchKey, and return the error
+ * code RC_NO_SUCH_RECORD.
+ * Using the returned "IndexCursor", you will have to call readForward()
+ * to retrieve the actual (key, payload) pair from the index.
+ * @param key[IN] the key to find
+ * @param cursor[OUT] the cursor pointing to the index entry with
+ *                    searchKey or immediately behind the largest key
+ *                    smaller than searchKey.
+ * @return 0 if searchKey is found. Othewise an error code
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::locate(const Key& searchKey, IndexCursor& cursor)
+{
+	NonLeafNode nonLeafNode;
+	PageId readPid = rootPid;
+	int height = treeHeight;
+
+	// an empty tree has no leaf node. readForward() stops right away.
+	if (treeHeight == 0)
+	{
+		cursor.pid = 0;
+		cursor.eid = 0;
+		return RC_NO_SUCH_RECORD;
+	}
+
+	// processing non-leaf nodes
+	while (height > 1)
+	{
+		// read the node from Pagefile
+		RC nonLeafRC = nonLeafNode.read(readPid, pf);
+
+		// if read error, return the error code
+		if (nonLeafRC != 0)
+			return nonLeafRC;
+
+		// locate the next node that we have to examine. a split may leave
+		// entries with a key equal to the separator in the left child, so we
+		// go left on such a separator. readForward() moves on to the right
+		// child if none of them is there.
+		nonLeafRC = nonLeafNode.locateLeftChildPtr(searchKey, readPid);
+
+		// if locate fails, return the error code
+		if (nonLeafRC != 0)
+			return nonLeafRC;
+
+		// examine the next level of the tree
+		height--;
+	}
+
+	// if we reached here, we have gotten to our leaf node
+	LeafNode leafNode;
+
+	// read the node from Pagefile
+	RC leafRC = leafNode.read(readPid, pf);
+
+	// if read error, return the error code
+	if (leafRC != 0)
+		return leafRC;
+
+	// Find the entry whose key value is larger than or equal to searchKey
+	// We have to add 1 because our locate function works differently
+	int eid;
+
+	// Try to locate the searchKey
+	leafNode.locate(searchKey, eid);
+
+	// set the cursor and return
+	cursor.pid = readPid;
+	cursor.eid = eid + 1;
+
+    return 0;
+}
+
+/*
+ * Orders the positions of an array of keys by their keys.
+ */
+template<class Key, class Compare>
+struct KeyPositionOrder {
+  const Key* keys;
+
+  bool operator()(int a, int b) const
+  {
+    Compare less;
+    return less(keys[a], keys[b]);
+  }
+};
+
+/*
+ * Locate a batch of keys, as locate() does for each of them. The tree is
+ * walked down one level at a time. Sorted by key, the keys that are in the
+ * same node follow each other, so each node is read once for all of them.
+ * @param searchKeys[IN] the keys to find, in any order
+ * @param count[IN] the number of keys
+ * @param cursors[OUT] the cursor of each key, in the order of searchKeys
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::locateMany(const Key* searchKeys, int count, IndexCursor* cursors)
+{
+	// an empty tree has no leaf node. readForward() stops right away.
+	if (treeHeight == 0)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			cursors[i].pid = 0;
+			cursors[i].eid = 0;
+		}
+		return 0;
+	}
+
+	// the positions of the keys in key order
+	std::vector<int> order(count);
+	for (int i = 0; i < count; i++)
+		order[i] = i;
+	KeyPositionOrder<Key, Compare> byKey = { searchKeys };
+	std::sort(order.begin(), order.end(), byKey);
+
+	// the node that each key is in on the current level. the same
+	// separators as in locate() lead to the same leaf nodes
+	std::vector<PageId> at(count, rootPid);
+	RC errorMsg;
+	for (int height = treeHeight; height > 1; height--)
+	{
+		NonLeafNode nonLeafNode;
+		for (int i = 0; i < count; )
+		{
+			PageId readPid = at[order[i]];
+			if ((errorMsg = nonLeafNode.read(readPid, pf)) != 0)
+				return errorMsg;
+			for (; i < count && at[order[i]] == readPid; i++)
+				nonLeafNode.locateLeftChildPtr(searchKeys[order[i]], at[order[i]]);
+		}
+	}
+
+	// set the cursors in the leaf nodes
+	LeafNode leafNode;
+	for (int i = 0; i < count; )
+	{
+		PageId readPid = at[order[i]];
+		if ((errorMsg = leafNode.read(readPid, pf)) != 0)
+			return errorMsg;
+		for (; i < count && at[order[i]] == readPid; i++)
+		{
+			int eid;
+			leafNode.locate(searchKeys[order[i]], eid);
+			cursors[order[i]].pid = readPid;
+			cursors[order[i]].eid = eid + 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * Read the (key, payload) pair at the location specified by the index cursor,
+ * and move foward the cursor to the next entry.
+ * @param cursor[IN/OUT] the cursor pointing to an leaf-node index entry in the b+tree
+ * @param key[OUT] the key stored at the index cursor location.
+ * @param payload[OUT] the payload stored at the index cursor location.
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::readForward(IndexCursor& cursor, Key& key, Payload& payload)
+{
+    LeafNode leafNode;
+    PageId pid;
+    int eid;
+
+    // the cursor may point behind the last entry of a node: locate() does so
+    // when all keys of the leaf are smaller than searchKey, and a leaf may
+    // have become empty by remove(). move on to the next node in that case.
+    while (true)
+    {
+    	if (cursor.pid <= 0)
+    		return RC_END_OF_TREE;
+
+    	pid = cursor.pid;
+    	eid = cursor.eid;
+
+    	// read our leaf node from PageFile
+    	RC leafRC = leafNode.read(pid, pf);
+
+    	// if read error, return the error code
+    	if (leafRC != 0)
+    		return leafRC;
+
+    	if (eid < leafNode.getKeyCount())
+    		break;
+    	cursor.pid = leafNode.getNextNodePtr();
+    	cursor.eid = 0;
+    }
+
+    // read the entry from our leaf node
+    RC leafRC = leafNode.readEntry(eid, key, payload);
+
+    // if readEntry error, return the error code
+    if (leafRC != 0)
+    	return leafRC;
+
+    // Move the cursor to the next entry
+    eid++;
+
+    // if the one that we just the last element of the node
+    if (eid >= leafNode.getKeyCount())
+    {
+    	// move on to the next node
+    	cursor.pid = leafNode.getNextNodePtr();
+
+    	// set eid to 0, which denotes the first entry of a node
+    	eid = 0;
+
+
+    }
+
+    // update cursor's eid
+    cursor.eid = eid;
+    return 0;
+}
+
+/*
+ * Set the cursor to the last index entry whose key is not larger than
+ * searchKey, to read the entries from there on with readBackward().
+ * @param searchKey[IN] the key to find
+ * @param cursor[OUT] the cursor pointing to the last entry with a key
+ *                    not larger than searchKey
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::locateBackward(const Key& searchKey, IndexCursor& cursor)
+{
+	NonLeafNode nonLeafNode;
+	PageId readPid = rootPid;
+
+	// an empty tree has no leaf node. readBackward() stops right away.
+	if (treeHeight == 0)
+	{
+		cursor.pid = 0;
+		cursor.eid = -1;
+		return 0;
+	}
+
+	// go right on a separator equal to searchKey: the last entry with it
+	// is in the right child, or in a node before it if the right child has
+	// none. readBackward() moves on to the previous node in that case.
+	for (int height = treeHeight; height > 1; height--)
+	{
+		RC errorMsg = nonLeafNode.read(readPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+		errorMsg = nonLeafNode.locateChildPtr(searchKey, readPid);
+		if (errorMsg != 0)
+			return errorMsg;
+	}
+
+	LeafNode leafNode;
+	RC errorMsg = leafNode.read(readPid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	cursor.pid = readPid;
+	return leafNode.locateLast(searchKey, cursor.eid);
+}
+
+/*
+ * Read the (key, payload) pair at the location specified by the index
+ * cursor, and move the cursor back to the previous entry.
+ * A cursor with a negative eid points in front of the first entry of its
+ * node, and one with an eid past the last entry to the last one.
+ * @param cursor[IN/OUT] the cursor pointing to an leaf-node index entry in the b+tree
+ * @param key[OUT] the key stored at the index cursor location.
+ * @param payload[OUT] the payload stored at the index cursor location.
+ * @return error code. RC_END_OF_TREE if there is no entry left
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::readBackward(IndexCursor& cursor, Key& key, Payload& payload)
+{
+	LeafNode leafNode;
+
+	// move on to the previous node while the cursor is in front of the
+	// first entry of a node, which may also have become empty by remove()
+	while (true)
+	{
+		if (cursor.pid <= 0)
+			return RC_END_OF_TREE;
+
+		RC errorMsg = leafNode.read(cursor.pid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		cursor.eid = std::min(cursor.eid, leafNode.getKeyCount() - 1);
+		if (cursor.eid >= 0)
+			break;
+		cursor.pid = leafNode.getPrevNodePtr();
+		cursor.eid = INT_MAX;	// the last entry of the previous node
+	}
+
+	RC errorMsg = leafNode.readEntry(cursor.eid, key, payload);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	// move the cursor to the previous entry
+	if (--cursor.eid < 0)
+	{
+		cursor.pid = leafNode.getPrevNodePtr();
+		cursor.eid = INT_MAX;
+	}
+	return 0;
+}
+
+/**
+  * @param count[OUT] total number of keys in the BTree
+  * @return error code. 0 if no error
+  */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::getTotalKeyCount(int& count)
+{
+	NonLeafNode nonLeafNode;
+	PageId readPid = rootPid;
+	int height = treeHeight;
+	count = 0;
+
+	// processing non-leaf nodes
+	while (height > 1)
+	{
+		// read the node from Pagefile
+		RC nonLeafRC = nonLeafNode.read(readPid, pf);
+
+		// if read error, return the error code
+		if (nonLeafRC != 0)
+			return nonLeafRC;
+
+		// go to the left most child
+		readPid = nonLeafNode.getFirstChildPtr();
+
+		// examine the next level of the tree
+		height--;
+	}
+
+	// if we reached here, we have gotten to our leaf node
+	LeafNode leafNode;
+
+	// read the node from Pagefile
+	RC leafRC = leafNode.read(readPid, pf);
+	// if read error, return the error code
+	if (leafRC != 0)
+		return leafRC;
+	count += leafNode.getKeyCount();
+	readPid = leafNode.getNextNodePtr();
+
+	while (readPid < pf.endPid() && readPid != 0)
+	{
+		// read the node from Pagefile
+		leafRC = leafNode.read(readPid, pf);
+
+		// if read error, return the error code
+		if (leafRC != 0)
+			return leafRC;
+		count += leafNode.getKeyCount();
+		readPid = leafNode.getNextNodePtr();
+	}
+	return 0;
+}
+
+/*
+ * Remove the (key, payload) pair from the index.
+ * @param key[IN] the key of the entry to remove
+ * @param payload[IN] the payload of the entry to remove
+ * @return error code. RC_NO_SUCH_RECORD if there is no such entry
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::remove(const Key& key, const Payload& payload)
+{
+	IndexCursor cursor;
+	LeafNode leafNode;
+
+	lastLeafPid = 0;
+	RC errorMsg = findEntry(key, payload, cursor);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	errorMsg = leafNode.read(cursor.pid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+	errorMsg = leafNode.remove(cursor.eid);
+	if (errorMsg != 0)
+		return errorMsg;
+	return leafNode.write(cursor.pid, pf);
+}
+
+/*
+ * Point the (key, oldPayload) entry of the index to newPayload.
+ * @param key[IN] the key of the entry
+ * @param oldPayload[IN] the payload stored in the entry
+ * @param newPayload[IN] the new payload of the entry
+ * @return error code. RC_NO_SUCH_RECORD if there is no such entry
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::replace(const Key& key, const Payload& oldPayload, const Payload& newPayload)
+{
+	IndexCursor cursor;
+	LeafNode leafNode;
+
+	lastLeafPid = 0;
+	RC errorMsg = findEntry(key, oldPayload, cursor);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	errorMsg = leafNode.read(cursor.pid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+	errorMsg = leafNode.setPayload(cursor.eid, newPayload);
+	// a compressed node may have no room for the new payload. the entry
+	// then leaves the node and is inserted again, splitting a node if needed.
+	if (errorMsg == RC_NODE_FULL)
+	{
+		if ((errorMsg = leafNode.remove(cursor.eid)) != 0 ||
+		    (errorMsg = leafNode.write(cursor.pid, pf)) != 0)
+			return errorMsg;
+		return insert(key, newPayload);
+	}
+	if (errorMsg != 0)
+		return errorMsg;
+	return leafNode.write(cursor.pid, pf);
+}
+
+/*
+ * Find the leaf node entry with the (key, payload) pair.
+ * @param key[IN] the key of the entry
+ * @param payload[IN] the payload of the entry
+ * @param cursor[OUT] the location of the entry
+ * @return error code. RC_NO_SUCH_RECORD if there is no such entry
+ */
+template<class Key, class Payload, class Compare>
+RC BTree<Key, Payload, Compare>::findEntry(const Key& key, const Payload& payload, IndexCursor& cursor)
+{
+	if (treeHeight == 0)
+		return RC_NO_SUCH_RECORD;
+
+	// entries with the same key may span several leaf nodes.
+	// locate() finds the first of them and we walk forward.
+	RC errorMsg = locate(key, cursor);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	Compare less;
+	LeafNode leafNode;
+	Key entryKey;
+	Payload entryPayload;
+	while (cursor.pid > 0)
+	{
+		errorMsg = leafNode.read(cursor.pid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		for (; cursor.eid < leafNode.getKeyCount(); cursor.eid++)
+		{
+			leafNode.readEntry(cursor.eid, entryKey, entryPayload);
+			if (less(key, entryKey))
+				return RC_NO_SUCH_RECORD;
+			if (entryPayload == payload)
+				return 0;
+		}
+
+		// move on to the next node
+		cursor.pid = leafNode.getNextNodePtr();
+		cursor.eid = 0;
+	}
+	return RC_NO_SUCH_RECORD;
+}
+
+// START: BTreeCursor
+
+template<class Key, class Payload, class Compare>
+BTreeCursor<Key, Payload, Compare>::BTreeCursor()
+	: pf(NULL), pid(0), eid(0)
+{
+}
+
+/*
+ * Position the cursor at the first entry of tree whose key is not
+ * smaller than searchKey, and read the leaf node of the entry.
+ * @param tree[IN] the open tree to read
+ * @param searchKey[IN] the key to find
+ * @return error code. 0 if no error
+ */
+template<class Key, class Payload, class Compare>
+RC BTreeCursor<Key, Payload, Compare>::locate(Tree& tree, const Key& searchKey)
+{
+	IndexCursor cursor;
+	RC errorMsg = tree.locate(searchKey, cursor);
+	if (errorMsg != 0 && errorMsg != RC_NO_SUCH_RECORD)
+		return errorMsg;
+
+	pf = &tree.pf;
+	pid = cursor.pid;
+	eid = cursor.eid;
+	if (pid > 0)
+		return leaf.read(pid, *pf);
+	return 0;
+}
+
+/*
+ * Read the entry at the cursor and move the cursor to the next entry.
+ * @param key[OUT] the key of the entry
+ * @param payload[OUT] the payload of the entry
+ * @return error code. RC_END_OF_TREE if there is no entry left
+ */
+template<class Key, class Payload, class Compare>
+RC BTreeCursor<Key, Payload, Compare>::next(Key& key, Payload& payload)
+{
+	RC errorMsg = advance();
+	if (errorMsg != 0)
+		return errorMsg;
+	return leaf.readEntry(eid++, key, payload);
+}
+
+/*
+ * Read up to n entries of the current leaf node from the cursor on, and
+ * move the cursor behind them.
+ * @param n[IN] the most entries to read
+ * @param keys[OUT] the keys of the entries
+ * @param payloads[OUT] the payloads of the entries
+ * @param count[OUT] the number of entries read
+ * @return error code. RC_END_OF_TREE if there is no entry left
+ */
+template<class Key, class Payload, class Compare>
+RC BTreeCursor<Key, Payload, Compare>::next(int n, Key* keys, Payload* payloads, int& count)
+{
+	count = 0;
+	RC errorMsg = advance();
+	if (errorMsg != 0)
+		return errorMsg;
+
+	int end = std::min(leaf.getKeyCount(), eid + n);
+	for (; eid < end; eid++, count++)
+	{
+		errorMsg = leaf.readEntry(eid, keys[count], payloads[count]);
+		if (errorMsg != 0)
+			return errorMsg;
+	}
+	return 0;
+}
+
+/*
+ * Move on to the next leaf node while the cursor is behind the last entry
+ * of its leaf. locate() leaves the cursor there when all keys of the leaf
+ * are smaller than searchKey, and a leaf may be empty after remove().
+ * @return error code. RC_END_OF_TREE behind the last leaf node
+ */
+template<class Key, class Payload, class Compare>
+RC BTreeCursor<Key, Payload, Compare>::advance()
+{
+	while (pid > 0 && eid >= leaf.getKeyCount())
+	{
+		pid = leaf.getNextNodePtr();
+		eid = 0;
+		if (pid > 0)
+		{
+			RC errorMsg = leaf.read(pid, *pf);
+			if (errorMsg != 0)
+				return errorMsg;
+		}
+	}
+	return (pid > 0) ? 0 : RC_END_OF_TREE;
+}
+
+#endif /* BTREE_H */
@@ -13,100 +13,32 @@
 #include "Bruinbase.h"
 #include "PageFile.h"
 #include "RecordFile.h"
-             
+#include "BTreeNode.h"
+#include "BTree.h"
+
 /**
- * The data structure to point to a particular entry at a b+tree leaf node.
- * An IndexCursor consists of pid (PageId of the leaf node) and 
- * eid (the location of the index entry inside the node).
- * IndexCursor is used for index lookup and traversal.
+ * The nodes of the index of Bruinbase: the compressed BTLeafNode and the
+ * Eytzinger BTNonLeafNode, instead of the generic nodes of BTree.
  */
-typedef struct {
-  // PageId of the index entry
-  PageId  pid;  
-  // The entry number inside the node
-  int     eid;  
-} IndexCursor;
+template<>
+struct BTreeNodes<int, RecordId, std::less<int> > {
+  typedef BTLeafNode    Leaf;
+  typedef BTNonLeafNode NonLeaf;
+};
 
 /**
- * Implements a B-Tree index for bruinbase.
- * 
+ * Implements a B-Tree index for bruinbase: the BTree from int keys to the
+ * RecordIds of the tuples. The code of the tree is compiled once, in
+ * BTreeIndex.cc.
  */
-class BTreeIndex {
- public:
-  BTreeIndex();
-
-  // pid value where we store treeHeight and our rootPid
-  static const int BTREE_BOOT_UP_PID = 0;
-
-  /**
-   * Open the index file in read or write mode.
-   * Under 'w' mode, the index file should be created if it does not exist.
-   * @param indexname[IN] the name of the index file
-   * @param mode[IN] 'r' for read, 'w' for write
-   * @return error code. 0 if no error
-   */
-  RC open(const std::string& indexname, char mode);
-
-  /**
-   * Close the index file.
-   * @return error code. 0 if no error
-   */
-  RC close();
-    
-  /**
-   * Insert (key, RecordId) pair to the index.
-   * @param key[IN] the key for the value inserted into the index
-   * @param rid[IN] the RecordId for the record being inserted into the index
-   * @return error code. 0 if no error
-   */
-  RC insert(int key, const RecordId& rid);
+typedef BTree<int, RecordId> BTreeIndex;
 
-  /**
-   * Run the standard B+Tree key search algorithm and identify the
-   * leaf node where searchKey may exist. If an index entry with
-   * searchKey exists in the leaf node, set IndexCursor to its location 
-   * (i.e., IndexCursor.pid = PageId of the leaf node, and
-   * IndexCursor.eid = the searchKey index entry number.) and return 0. 
-   * If not, set IndexCursor.pid = PageId of the leaf node and 
-   * IndexCursor.eid = the index entry immediately after the largest 
-   * index key that is smaller than searchKey, and return the error 
-   * code RC_NO_SUCH_RECORD.
-   * Using the returned "IndexCursor", you will have to call readForward()
-   * to retrieve the actual (key, rid) pair from the index.
-   * @param key[IN] the key to find
-   * @param cursor[OUT] the cursor pointing to the index entry with 
-   *                    searchKey or immediately behind the largest key 
-   *                    smaller than searchKey.
-   * @return 0 if searchKey is found. Othewise, an error code
-   */
-  RC locate(int searchKey, IndexCursor& cursor);
-
-  /**
-   * Read the (key, rid) pair at the location specified by the index cursor,
-   * and move foward the cursor to the next entry.
-   * @param cursor[IN/OUT] the cursor pointing to an leaf-node index entry in the b+tree
-   * @param key[OUT] the key stored at the index cursor location
-   * @param rid[OUT] the RecordId stored at the index cursor location
-   * @return error code. 0 if no error
-   */
-  RC readForward(IndexCursor& cursor, int& key, RecordId& rid);
-
-  /**
-   * @param count[OUT] total number of keys in the BTreeIndex
-   * @return error code. 0 if no error
-   */
-  RC getTotalKeyCount(int& count);
-  
- private:
-  PageFile pf;         /// the PageFile used to store the actual b+tree in disk
+/**
+ * A cursor that reads the index in key order, keeping the current leaf.
+ */
+typedef BTreeCursor<int, RecordId> BTreeIndexCursor;
 
-  PageId   rootPid;    /// the PageId of the root node
-  int      treeHeight; /// the height of the tree
-  /// Note that the content of the above two variables will be gone when
-  /// this class is destructed. Make sure to store the values of the two 
-  /// variables in disk, so that they can be reconstructed when the index
-  /// is opened again later.
-  char buffer[PageFile::PAGE_SIZE];
-};
+extern template class BTree<int, RecordId>;
+extern template class BTreeCursor<int, RecordId>;
 
 #endif /* BTREEINDEX_H */
@@ -1,38 +1,203 @@
 #include "BTreeNode.h"
+#include "KeySearch.h"
 #include <math.h>
+#include <algorithm>
 #include <string.h>
+#include <limits.h>
 #include <iostream>
 #include <stdio.h>
 
 using namespace std;
 
+/*
+ * Check the header of a node read from the disk.
+ * @param buffer[IN] the page of the node
+ * @param type[IN] the NodeHeader::Type the node must have
+ * @return 0 if the node has the given type and the current format.
+ */
+static RC checkHeader(const char* buffer, int type)
+{
+	const NodeHeader* header = (const NodeHeader*) buffer;
+	if (header->version != NodeHeader::VERSION || header->type != type)
+		return RC_INVALID_FILE_FORMAT;
+	return 0;
+}
+
+/*
+ * Start an empty node of the given type in a page buffer.
+ */
+static void initHeader(char* buffer, int type)
+{
+	std::fill(buffer, buffer + PageFile::PAGE_SIZE, 0);
+	NodeHeader* header = (NodeHeader*) buffer;
+	header->version = NodeHeader::VERSION;
+	header->type = type;
+}
+
+/*
+ * Count the keys of a node that are smaller than searchKey (or not larger
+ * with orEqual) with the SIMD kernels of KeySearch. The keys of every node
+ * format are stored contiguously.
+ */
+static int countKeys(const int* keys, int count, int searchKey, bool orEqual)
+{
+	return orEqual ? KeySearch::countNotGreater(keys, count, 1, searchKey)
+	               : KeySearch::countLess(keys, count, 1, searchKey);
+}
+
+/*
+ * The number of bytes needed to store the numbers from 0 to range.
+ */
+static int packedWidth(unsigned range)
+{
+	return range <= 0xff ? 1 : (range <= 0xffff ? 2 : 4);
+}
+
+/*
+ * Read the i-th number of a packed array of numbers of the given width.
+ */
+static unsigned readPacked(const char* field, int width, int i)
+{
+	if (width == 1)
+		return ((const unsigned char*) field)[i];
+	if (width == 2) {
+		unsigned short value;
+		memcpy(&value, field + 2 * i, 2);
+		return value;
+	}
+	unsigned value;
+	memcpy(&value, field + 4 * i, 4);
+	return value;
+}
+
+/*
+ * Write the i-th number of a packed array of numbers of the given width.
+ */
+static void writePacked(char* field, int width, int i, unsigned value)
+{
+	if (width == 1) {
+		((unsigned char*) field)[i] = (unsigned char) value;
+	} else if (width == 2) {
+		unsigned short narrow = (unsigned short) value;
+		memcpy(field + 2 * i, &narrow, 2);
+	} else {
+		memcpy(field + 4 * i, &value, 4);
+	}
+}
+
+/*
+ * Plan the compressed layout of count entries of a leaf in frame and
+ * return the number of bytes it takes. The entries are stored flat, with
+ * a key offset per entry, or as posting lists: each run of equal keys
+ * stores its key and the smallest PageId of its RecordIds once, and each
+ * entry only the distance of its PageId from that one and its slot id.
+ * The smaller of the two is used, so a node of few distinct keys is not
+ * filled with copies of them. The keys are sorted, so their range is from
+ * the first to the last one.
+ */
+static int planFrame(const int* keys, const RecordId* rids, int count, BTLeafNode::Frame& frame)
+{
+	memset(&frame, 0, sizeof(frame));
+	frame.keyWidth = frame.pidWidth = frame.sidWidth = 1;
+	if (count == 0)
+		return 0;
+
+	PageId minPid = rids[0].pid, maxPid = rids[0].pid;
+	int maxSid = 0, runCount = 0;
+	unsigned maxDelta = 0;
+	for (int start = 0, end; start < count; start = end) {
+		// the run of the key at start, and the smallest PageId in it
+		PageId runPid = rids[start].pid;
+		for (end = start; end < count && keys[end] == keys[start]; end++)
+			runPid = min(runPid, rids[end].pid);
+		for (int i = start; i < end; i++) {
+			maxPid = max(maxPid, rids[i].pid);
+			maxSid = max(maxSid, rids[i].sid);
+			maxDelta = max(maxDelta, (unsigned) rids[i].pid - (unsigned) runPid);
+		}
+		minPid = min(minPid, runPid);
+		runCount++;
+	}
+	frame.keyBase = keys[0];
+	frame.pidBase = minPid;
+	frame.keyWidth = packedWidth((unsigned) keys[count - 1] - (unsigned) keys[0]);
+	frame.pidWidth = packedWidth((unsigned) maxPid - (unsigned) minPid);
+	frame.sidWidth = packedWidth((unsigned) maxSid);
+
+	int flatSize = count * (frame.keyWidth + frame.pidWidth + frame.sidWidth);
+	int runWidth = packedWidth((unsigned) count);
+	int deltaWidth = packedWidth(maxDelta);
+	int postingSize = runCount * (frame.keyWidth + runWidth + frame.pidWidth) +
+	                  count * (deltaWidth + frame.sidWidth);
+	if (postingSize >= flatSize)
+		return flatSize;
+	frame.runWidth = runWidth;
+	frame.deltaWidth = deltaWidth;
+	frame.runCount = runCount;
+	return postingSize;
+}
+
+/*
+ * The number of bytes that count entries take in a compressed leaf.
+ */
+static int packedSize(const int* keys, const RecordId* rids, int count)
+{
+	BTLeafNode::Frame frame;
+	return planFrame(keys, rids, count, frame);
+}
+
+/*
+ * Move the RecordId at position from of rids to position to, shifting the
+ * ones in between by one.
+ */
+static void moveRecordId(RecordId* rids, int from, int to)
+{
+	if (to < from)
+		std::rotate(rids + to, rids + from, rids + from + 1);
+	else
+		std::rotate(rids + from, rids + from + 1, rids + to + 1);
+}
+
 /*
  * Default Constructor for a BTLeafNode
  */
 BTLeafNode::BTLeafNode()
 {
-	std::fill(buffer, buffer + PageFile::PAGE_SIZE, 0);
+	initHeader(buffer, NodeHeader::LEAF);
+	keysDecoded = ridsDecoded = true;
+	dirty = true;
 }
 
 /*
  * Read the content of the node from the page pid in the PageFile pf.
+ * The entries are decoded only when they are needed.
  * @param pid[IN] the PageId to read
  * @param pf[IN] PageFile to read from
  * @return 0 if successful. Return an error code if there is an error.
  */
 RC BTLeafNode::read(PageId pid, const PageFile& pf)
 {
-	return pf.read(pid, buffer);
+	RC errorMsg = pf.read(pid, buffer);
+	keysDecoded = ridsDecoded = dirty = false;
+	if (errorMsg != 0)
+		return errorMsg;
+	return checkHeader(buffer, NodeHeader::LEAF);
 }
-    
+
 /*
  * Write the content of the node to the page pid in the PageFile pf.
+ * A node that has been changed is encoded again first.
  * @param pid[IN] the PageId to write to
  * @param pf[IN] PageFile to write to
  * @return 0 if successful. Return an error code if there is an error.
  */
 RC BTLeafNode::write(PageId pid, PageFile& pf)
 {
+	if (dirty) {
+		RC errorMsg = encode();
+		if (errorMsg != 0)
+			return errorMsg;
+	}
 	return pf.write(pid, buffer);
 }
 
@@ -42,16 +207,7 @@ RC BTLeafNode::write(PageId pid, PageFile& pf)
  */
 int BTLeafNode::getKeyCount()
 {
-	int count = 0;
-	Entry* entry = (Entry*) getEntryStart();
-	for(int i = 0; i < MAX_LEAF_ENTRIES; i++)
-	{
-		if (entry->key == 0)
-			break;
-		count++;
-		entry++;
-	}
-	return count;
+	return ((NodeHeader*) buffer)->keyCount;
 }
 
 /**
@@ -62,63 +218,50 @@ RC BTLeafNode::setKeyCount(int number)
 {
 	if (number < 0 || number > MAX_LEAF_ENTRIES)
 		return RC_INVALID_CURSOR;
-	keyCount = number;
+	decode();
+	((NodeHeader*) buffer)->keyCount = number;
+	dirty = true;
 	return 0;
 }
 
 
 /*
- * Insert a (key, rid) pair to the node.
+ * Insert a (key, rid) pair to the node, among the entries of the same
+ * key in the order of their RecordIds.
  * @param key[IN] the key to insert
  * @param rid[IN] the RecordId to insert
  * @return 0 if successful. Return an error code if the node is full.
  */
 RC BTLeafNode::insert(int key, const RecordId& rid)
 {
-	// If the node is full, return RC_NODE_FULL
-	if (getKeyCount() >= MAX_LEAF_ENTRIES)
+	int count = getKeyCount();
+	if (count >= MAX_LEAF_ENTRIES)
 		return RC_NODE_FULL;
-	int eid;
-	locate(key, eid);
 
-	// When our leaf node is empty, just add the entry at the front
-	if (getKeyCount() == 0)
-	{
-		Entry* entry = (Entry*) getEntryStart();
-		entry->key = key;
-		entry->rid.pid = rid.pid;
-		entry->rid.sid = rid.sid;
-	}
-	// When key is larger than any other elements, we just need to add the entry at the end
-	else if (eid + 1 == getKeyCount())
-	{
-		Entry* entry = (Entry*) getEntryStart() + eid + 1;
-		entry->key = key;
-		entry->rid.pid = rid.pid;
-		entry->rid.sid = rid.sid;
-	}
-	// Otherwise, shift everything to the right then insert the entry
-	else
-	{	
-		Entry* entry = (Entry*) getEntryStart() + getKeyCount();
-		Entry* prevEntry = entry - 1;
-		Entry* newEntry = (Entry*) getEntryStart() + eid + 1;
-		for (; prevEntry >= newEntry; entry--, prevEntry--)
-		{
-			entry->key = prevEntry->key;
-			entry->rid.pid = prevEntry->rid.pid;
-			entry->rid.sid = prevEntry->rid.sid;
-		}
-		newEntry->key = key;
-		newEntry->rid.pid = rid.pid;
-		newEntry->rid.sid = rid.sid;
+	// shift the entries behind the new one to the right
+	int pos = insertPosition(key, rid);
+	memmove(keys + pos + 1, keys + pos, (count - pos) * sizeof(int));
+	memmove(rids + pos + 1, rids + pos, (count - pos) * sizeof(RecordId));
+	keys[pos] = key;
+	rids[pos] = rid;
+
+	// If the entries do not fit in the page any more, the node is full
+	if (packedSize(keys, rids, count + 1) > PACKED_SIZE) {
+		memmove(keys + pos, keys + pos + 1, (count - pos) * sizeof(int));
+		memmove(rids + pos, rids + pos + 1, (count - pos) * sizeof(RecordId));
+		return RC_NODE_FULL;
 	}
-	return 0;
+	return setKeyCount(count + 1);
 }
 
 /*
  * Insert the (key, rid) pair to the node
- * and split the node half and half with sibling.
+ * and split the node with sibling.
+ * The node is split half and half, except at the edges: a new entry
+ * behind all others leaves the node 90% full, and one before all others
+ * leaves the sibling 90% full. The split point moves further when one of
+ * the nodes would not fit in a page, since the size of an entry depends
+ * on its neighbors.
  * The first key of the sibling node is returned in siblingKey.
  * @param key[IN] the key to insert.
  * @param rid[IN] the RecordId to insert.
@@ -126,47 +269,149 @@ RC BTLeafNode::insert(int key, const RecordId& rid)
  * @param siblingKey[OUT] the first key in the sibling node after split.
  * @return 0 if successful. Return an error code if there is an error.
  */
-RC BTLeafNode::insertAndSplit(int key, const RecordId& rid, 
+RC BTLeafNode::insertAndSplit(int key, const RecordId& rid,
                               BTLeafNode& sibling, int& siblingKey)
-{ 
+{
 	int oldKeyCount = getKeyCount();
-	if (oldKeyCount < MAX_LEAF_ENTRIES)
-		return RC_INVALID_CURSOR; // node is not full, does not need to be split
 	if (sibling.getKeyCount() != 0)
 		return RC_INVALID_CURSOR; // sibling node must be empty
-	int eid;
-	locate(key, eid); // find relative position of where our insertion should be
-	bool insertIntoCurrent = false;
-	double halfwayEntry = ((double) (oldKeyCount-1)) /2.0;
-	int newKeyCount = 0;
-	if (((double) eid) < halfwayEntry) // insert into current node
-	{
-		newKeyCount = ((int) floor(((double) oldKeyCount)/2.0));
-		insertIntoCurrent = true;
-	}
-	else // insert into sibling node
-	{
-		newKeyCount = ((int) ceil(((double) oldKeyCount)/2.0));
-	}
-	// copy half of our values into sibling node
-	int siblingKeyCount = (MAX_LEAF_ENTRIES - newKeyCount);
-	memcpy((Entry*) sibling.getEntryStart(), (Entry*) getEntryStart() + newKeyCount, siblingKeyCount * sizeof(Entry));
-	// clear old memory in current node
-	memset((Entry*) getEntryStart() + newKeyCount, '\0', siblingKeyCount * sizeof(Entry));
+	int pos = insertPosition(key, rid); // find relative position of where our insertion should be
+
+	// put all entries, the new one included, in one sorted list
+	int count = oldKeyCount + 1;
+	int allKeys[MAX_LEAF_ENTRIES + 1];
+	RecordId allRids[MAX_LEAF_ENTRIES + 1];
+	memcpy(allKeys, keys, pos * sizeof(int));
+	memcpy(allRids, rids, pos * sizeof(RecordId));
+	allKeys[pos] = key;
+	allRids[pos] = rid;
+	memcpy(allKeys + pos + 1, keys + pos, (oldKeyCount - pos) * sizeof(int));
+	memcpy(allRids + pos + 1, rids + pos, (oldKeyCount - pos) * sizeof(RecordId));
+	if (count <= MAX_LEAF_ENTRIES && packedSize(allKeys, allRids, count) <= PACKED_SIZE)
+		return RC_INVALID_CURSOR; // node is not full, does not need to be split
+
+	RC errorMsg = distribute(allKeys, allRids, count, nodeSplitPoint(count, pos), sibling);
+	if (errorMsg != 0)
+		return errorMsg;
 	sibling.setNextNodePtr(getNextNodePtr());
 	// current node's nextPointer needs to be set in the function that calls this during sibling node creation
-	if (insertIntoCurrent)
-	{
-		if (insert(key, rid) == RC_NODE_FULL)
-			return RC_NODE_FULL;
+
+	siblingKey = sibling.keys[0]; // needs to be used to set parent node pointer
+	return 0;
+}
+
+/*
+ * Insert the (key, rid) pair to the node and move entries between the
+ * node and its right sibling, so that both hold about half of them.
+ * The first key of the sibling node after the move is returned in
+ * siblingKey, and replaces the key between the two nodes in the parent.
+ * @param key[IN] the key to insert. It must be smaller than the first key of sibling.
+ * @param rid[IN] the RecordId to insert.
+ * @param sibling[IN/OUT] the next node under the same parent.
+ * @param siblingKey[OUT] the first key in the sibling node after the move.
+ * @return 0 if successful. RC_NODE_FULL if the entries do not fit in the two nodes.
+ */
+RC BTLeafNode::insertAndRedistribute(int key, const RecordId& rid,
+                                     BTLeafNode& sibling, int& siblingKey)
+{
+	int oldKeyCount = getKeyCount();
+	int siblingKeyCount = sibling.getKeyCount();
+	int pos = insertPosition(key, rid);
+	sibling.decode();
+
+	// put the entries of both nodes and the new one in one sorted list
+	int count = oldKeyCount + 1 + siblingKeyCount;
+	int allKeys[2 * MAX_LEAF_ENTRIES + 1];
+	RecordId allRids[2 * MAX_LEAF_ENTRIES + 1];
+	memcpy(allKeys, keys, pos * sizeof(int));
+	memcpy(allRids, rids, pos * sizeof(RecordId));
+	allKeys[pos] = key;
+	allRids[pos] = rid;
+	memcpy(allKeys + pos + 1, keys + pos, (oldKeyCount - pos) * sizeof(int));
+	memcpy(allRids + pos + 1, rids + pos, (oldKeyCount - pos) * sizeof(RecordId));
+	memcpy(allKeys + oldKeyCount + 1, sibling.keys, siblingKeyCount * sizeof(int));
+	memcpy(allRids + oldKeyCount + 1, sibling.rids, siblingKeyCount * sizeof(RecordId));
+
+	RC errorMsg = distribute(allKeys, allRids, count, count / 2, sibling);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	siblingKey = sibling.keys[0];
+	return 0;
+}
+
+/*
+ * Fill the empty node with the first entries of a sorted list, as many as
+ * fit in fillPercent percent of the page, and at least one. The size of
+ * the compressed entries only grows with their number, so the count is
+ * found by a binary search.
+ * @param allKeys[IN] the keys of the entries, sorted
+ * @param allRids[IN] the RecordIds of the entries, sorted within a key
+ * @param count[IN] the number of entries in the list
+ * @param fillPercent[IN] how full the node should be, from 1 to 100
+ * @param taken[OUT] the number of entries stored in the node
+ * @return 0 if successful. RC_INVALID_CURSOR if the node is not empty.
+ */
+RC BTLeafNode::fill(const int* allKeys, const RecordId* allRids, int count,
+                    int fillPercent, int& taken)
+{
+	if (getKeyCount() != 0 || count < 1)
+		return RC_INVALID_CURSOR;
+	decode();
+
+	int budget = PACKED_SIZE * fillPercent / 100;
+	int lo = 1, hi = (count < MAX_LEAF_ENTRIES) ? count : MAX_LEAF_ENTRIES;
+	while (lo < hi) {
+		int mid = (lo + hi + 1) / 2;
+		if (packedSize(allKeys, allRids, mid) <= budget)
+			lo = mid;
+		else
+			hi = mid - 1;
 	}
-	else
-	{
-		if (sibling.insert(key, rid) == RC_NODE_FULL)
-			return RC_NODE_FULL;
+	memcpy(keys, allKeys, lo * sizeof(int));
+	memcpy(rids, allRids, lo * sizeof(RecordId));
+	taken = lo;
+	return setKeyCount(lo);
+}
+
+/*
+ * Store a sorted list of entries in the node and its sibling, split at
+ * the point closest to target where the entries of both nodes fit.
+ * @param allKeys[IN] the keys of the entries
+ * @param allRids[IN] the RecordIds of the entries
+ * @param count[IN] the number of entries
+ * @param target[IN] the preferred number of entries for this node
+ * @param sibling[IN/OUT] the node that takes the rest of the entries
+ * @return 0 if successful. RC_NODE_FULL if there is no such split point.
+ */
+RC BTLeafNode::distribute(const int* allKeys, const RecordId* allRids, int count,
+                          int target, BTLeafNode& sibling)
+{
+	int newKeyCount = 0;
+	for (int offset = 0; offset < count && newKeyCount == 0; offset++) {
+		int candidates[2] = { target - offset, target + offset };
+		for (int i = 0; i < 2 && newKeyCount == 0; i++) {
+			int split = candidates[i];
+			if (split < 1 || split >= count ||
+			    split > MAX_LEAF_ENTRIES || count - split > MAX_LEAF_ENTRIES)
+				continue;
+			if (packedSize(allKeys, allRids, split) <= PACKED_SIZE &&
+			    packedSize(allKeys + split, allRids + split, count - split) <= PACKED_SIZE)
+				newKeyCount = split;
+		}
 	}
+	if (newKeyCount == 0)
+		return RC_NODE_FULL;
 
-	siblingKey = ((Entry*)sibling.getEntryStart())->key; // needs to be used to set parent node pointer
+	// keep the first part and move the rest into sibling node
+	int siblingKeyCount = count - newKeyCount;
+	sibling.decode();
+	memcpy(keys, allKeys, newKeyCount * sizeof(int));
+	memcpy(rids, allRids, newKeyCount * sizeof(RecordId));
+	memcpy(sibling.keys, allKeys + newKeyCount, siblingKeyCount * sizeof(int));
+	memcpy(sibling.rids, allRids + newKeyCount, siblingKeyCount * sizeof(RecordId));
+	setKeyCount(newKeyCount);
+	sibling.setKeyCount(siblingKeyCount);
 	return 0;
 }
 
@@ -185,16 +430,76 @@ RC BTLeafNode::insertAndSplit(int key, const RecordId& rid,
  */
 RC BTLeafNode::locate(int searchKey, int& eid)
 {
-	Entry* entry = (Entry*) getEntryStart();
-	for (eid = 0; eid < getKeyCount() && entry->key < searchKey; eid++, entry++)
-	{
-		if (entry->key == searchKey)
-			return 0;
+	int count = getKeyCount();
+	if (keysDecoded) {
+		eid = countKeys(keys, count, searchKey, false) - 1;
+		return RC_NO_SUCH_RECORD;
+	}
+
+	// search the key offsets in the page without decoding them
+	const Frame* frame = getFrame();
+	const char* packed = getPacked();
+	unsigned offset = (unsigned) searchKey - (unsigned) frame->keyBase;
+	if (count == 0 || searchKey <= frame->keyBase) {
+		eid = -1;
+	} else if (frame->runWidth == 0) {
+		eid = KeySearch::countPackedLess(packed, frame->keyWidth, count, offset) - 1;
+	} else {
+		// the entry in front of the first run with a key not smaller
+		// than searchKey is the last one of the run before it
+		int run = KeySearch::countPackedLess(packed, frame->keyWidth, frame->runCount, offset);
+		packed += frame->runCount * frame->keyWidth;
+		eid = (int) readPacked(packed, frame->runWidth, run - 1) - 1;
 	}
-	eid--;
 	return RC_NO_SUCH_RECORD;
 }
 
+/*
+ * Set eid to the last entry whose key is not larger than searchKey,
+ * or to -1 if there is no such entry.
+ * @param searchKey[IN] the key to search for.
+ * @param eid[OUT] the entry number of the last key <= searchKey.
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTLeafNode::locateLast(int searchKey, int& eid)
+{
+	int count = getKeyCount();
+	if (keysDecoded) {
+		eid = countKeys(keys, count, searchKey, true) - 1;
+		return 0;
+	}
+
+	// search the key offsets in the page without decoding them
+	const Frame* frame = getFrame();
+	const char* packed = getPacked();
+	unsigned offset = (unsigned) searchKey - (unsigned) frame->keyBase;
+	if (count == 0 || searchKey < frame->keyBase) {
+		eid = -1;
+	} else if (frame->runWidth == 0) {
+		eid = (offset == UINT_MAX ? count : KeySearch::countPackedLess(packed, frame->keyWidth, count, offset + 1)) - 1;
+	} else {
+		// the last entry of the last run with a key not larger than searchKey
+		int runCount = frame->runCount;
+		int run = (offset == UINT_MAX ? runCount : KeySearch::countPackedLess(packed, frame->keyWidth, runCount, offset + 1));
+		packed += runCount * frame->keyWidth;
+		eid = (int) readPacked(packed, frame->runWidth, run - 1) - 1;
+	}
+	return 0;
+}
+
+// return the position of the (key, rid) entry to insert: behind the
+// smaller keys and the entries of the same key with smaller RecordIds
+int BTLeafNode::insertPosition(int key, const RecordId& rid)
+{
+	int eid;
+	locate(key, eid);
+	decode();
+	int pos = eid + 1, count = getKeyCount();
+	while (pos < count && keys[pos] == key && rids[pos] < rid)
+		pos++;
+	return pos;
+}
+
 /*
  * Read the (key, rid) pair from the eid entry.
  * @param eid[IN] the entry number to read the (key, rid) pair from
@@ -204,64 +509,272 @@ RC BTLeafNode::locate(int searchKey, int& eid)
  */
 RC BTLeafNode::readEntry(int eid, int& key, RecordId& rid)
 {
-	if (eid < 0 || eid >= getKeyCount())
+	int count = getKeyCount();
+	if (eid < 0 || eid >= count)
 		return RC_INVALID_CURSOR;
 
-	Entry* entry = (Entry*) getEntryStart();
-	entry += eid;
-	key = entry->key;
-	rid = entry->rid;
+	if (keysDecoded && ridsDecoded) {
+		key = keys[eid];
+		rid = rids[eid];
+		return 0;
+	}
+
+	// decode only the requested entry from the page
+	const Frame* frame = getFrame();
+	const char* packed = getPacked();
+	if (frame->runWidth == 0) {
+		key = (int) ((unsigned) frame->keyBase + readPacked(packed, frame->keyWidth, eid));
+		packed += count * frame->keyWidth;
+		rid.pid = (PageId) ((unsigned) frame->pidBase + readPacked(packed, frame->pidWidth, eid));
+		packed += count * frame->pidWidth;
+		rid.sid = (int) readPacked(packed, frame->sidWidth, eid);
+		return 0;
+	}
+
+	// the run of the entry is the first one that ends behind it
+	int runCount = frame->runCount;
+	const char* runEnds = packed + runCount * frame->keyWidth;
+	const char* runPids = runEnds + runCount * frame->runWidth;
+	const char* deltas = runPids + runCount * frame->pidWidth;
+	int run = KeySearch::countPackedLess(runEnds, frame->runWidth, runCount, eid + 1);
+	key = (int) ((unsigned) frame->keyBase + readPacked(packed, frame->keyWidth, run));
+	rid.pid = (PageId) ((unsigned) frame->pidBase + readPacked(runPids, frame->pidWidth, run) +
+	                    readPacked(deltas, frame->deltaWidth, eid));
+	rid.sid = (int) readPacked(deltas + count * frame->deltaWidth, frame->sidWidth, eid);
+	return 0;
+}
+
+/*
+ * Remove the eid entry from the node, shifting the entries behind it.
+ * @param eid[IN] the entry number to remove
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTLeafNode::remove(int eid)
+{
+	int count = getKeyCount();
+	if (eid < 0 || eid >= count)
+		return RC_INVALID_CURSOR;
+
+	// shift the entries behind eid to the left
+	decode();
+	memmove(keys + eid, keys + eid + 1, (count - eid - 1) * sizeof(int));
+	memmove(rids + eid, rids + eid + 1, (count - eid - 1) * sizeof(RecordId));
+	return setKeyCount(count - 1);
+}
+
+/*
+ * Change the RecordId of the eid entry. The entry moves among the entries
+ * of the same key to keep their RecordIds sorted.
+ * @param eid[IN] the entry number to change
+ * @param rid[IN] the new RecordId of the entry
+ * @return 0 if successful. RC_NODE_FULL if the entries do not fit in the
+ * page with the new RecordId.
+ */
+RC BTLeafNode::setPayload(int eid, const RecordId& rid)
+{
+	int count = getKeyCount();
+	if (eid < 0 || eid >= count)
+		return RC_INVALID_CURSOR;
+
+	decode();
+	RecordId old = rids[eid];
+	int pos = eid;
+	while (pos > 0 && keys[pos - 1] == keys[eid] && rid < rids[pos - 1])
+		pos--;
+	if (pos == eid) {
+		while (pos + 1 < count && keys[pos + 1] == keys[eid] && rids[pos + 1] < rid)
+			pos++;
+	}
+	moveRecordId(rids, eid, pos);
+	rids[pos] = rid;
+	if (packedSize(keys, rids, count) > PACKED_SIZE) {
+		rids[pos] = old;
+		moveRecordId(rids, pos, eid);
+		return RC_NODE_FULL;
+	}
+	dirty = true;
 	return 0;
 }
 
 /*
  * Return the pid of the next sibling node.
- * @return the PageId of the next sibling node 
+ * @return the PageId of the next sibling node
  */
 PageId BTLeafNode::getNextNodePtr()
 {
 	PageId pid;
-	memcpy(&pid, buffer, sizeof(PageId));
+	memcpy(&pid, getPageIDStart(), sizeof(PageId));
 	return pid;
 }
 
 /*
  * Set the pid of the next sibling node.
- * @param pid[IN] the PageId of the next sibling node 
+ * @param pid[IN] the PageId of the next sibling node
  * @return 0 if successful. Return an error code if there is an error.
  */
 RC BTLeafNode::setNextNodePtr(PageId pid)
 {
-	memcpy(buffer, &pid, sizeof(PageId));
+	memcpy(getPageIDStart(), &pid, sizeof(PageId));
 	return 0;
 }
 
+/*
+ * Return the pid of the previous sibling node.
+ * @return the PageId of the previous sibling node. 0 for the first node
+ */
+PageId BTLeafNode::getPrevNodePtr()
+{
+	PageId pid;
+	memcpy(&pid, getPageIDStart() + 1, sizeof(PageId));
+	return pid;
+}
 
 /*
- * get a void pointer (needs to be converted) to the start of the entries in the node
+ * Set the pid of the previous sibling node.
+ * @param pid[IN] the PageId of the previous sibling node
+ * @return 0 if successful. Return an error code if there is an error.
  */
-char* BTLeafNode::getEntryStart()
+RC BTLeafNode::setPrevNodePtr(PageId pid)
 {
-	return (char*) buffer + sizeof(PageId);
+	memcpy(getPageIDStart() + 1, &pid, sizeof(PageId));
+	return 0;
 }
+
 /*
- * Get a pointer to the start of the node
+ * Decode all entries of the page into keys and rids, so they can be changed.
+ */
+void BTLeafNode::decode()
+{
+	if (keysDecoded && ridsDecoded)
+		return;
+	int count = getKeyCount();
+	const Frame* frame = getFrame();
+	const char* packed = getPacked();
+
+	if (frame->runWidth == 0) {
+		if (!keysDecoded) {
+			for (int i = 0; i < count; i++)
+				keys[i] = (int) ((unsigned) frame->keyBase + readPacked(packed, frame->keyWidth, i));
+		}
+		if (!ridsDecoded) {
+			packed += count * frame->keyWidth;
+			for (int i = 0; i < count; i++)
+				rids[i].pid = (PageId) ((unsigned) frame->pidBase + readPacked(packed, frame->pidWidth, i));
+			packed += count * frame->pidWidth;
+			for (int i = 0; i < count; i++)
+				rids[i].sid = (int) readPacked(packed, frame->sidWidth, i);
+		}
+	} else {
+		// expand the runs of equal keys into one entry per RecordId
+		int runCount = frame->runCount;
+		const char* runEnds = packed + runCount * frame->keyWidth;
+		const char* runPids = runEnds + runCount * frame->runWidth;
+		const char* deltas = runPids + runCount * frame->pidWidth;
+		const char* sids = deltas + count * frame->deltaWidth;
+		for (int run = 0, i = 0; run < runCount; run++) {
+			int key = (int) ((unsigned) frame->keyBase + readPacked(packed, frame->keyWidth, run));
+			unsigned runPid = (unsigned) frame->pidBase + readPacked(runPids, frame->pidWidth, run);
+			for (int end = (int) readPacked(runEnds, frame->runWidth, run); i < end; i++) {
+				if (!keysDecoded)
+					keys[i] = key;
+				if (!ridsDecoded) {
+					rids[i].pid = (PageId) (runPid + readPacked(deltas, frame->deltaWidth, i));
+					rids[i].sid = (int) readPacked(sids, frame->sidWidth, i);
+				}
+			}
+		}
+	}
+	keysDecoded = ridsDecoded = true;
+}
+
+/*
+ * Encode keys and rids into the page in the layout planFrame() finds
+ * smaller. The keys are stored as offsets from the smallest key, the
+ * PageIds as offsets from the smallest PageId, or from the smallest one of
+ * their run of equal keys in posting lists, and the slot ids as they are,
+ * each in as few bytes as their largest value needs.
+ * @return 0 if successful. RC_NODE_FULL if the entries do not fit.
+ */
+RC BTLeafNode::encode()
+{
+	int count = getKeyCount();
+	Frame plan;
+	if (planFrame(keys, rids, count, plan) > PACKED_SIZE)
+		return RC_NODE_FULL;
+
+	Frame* frame = getFrame();
+	*frame = plan;
+	char* packed = getPacked();
+	memset(packed, 0, PACKED_SIZE);
+	if (frame->runWidth == 0) {
+		for (int i = 0; i < count; i++)
+			writePacked(packed, frame->keyWidth, i, (unsigned) keys[i] - (unsigned) frame->keyBase);
+		packed += count * frame->keyWidth;
+		for (int i = 0; i < count; i++)
+			writePacked(packed, frame->pidWidth, i, (unsigned) rids[i].pid - (unsigned) frame->pidBase);
+		packed += count * frame->pidWidth;
+		for (int i = 0; i < count; i++)
+			writePacked(packed, frame->sidWidth, i, (unsigned) rids[i].sid);
+	} else {
+		// one key, end and smallest PageId per run, then the PageId
+		// distances and slot ids of all entries
+		int runCount = frame->runCount;
+		char* runEnds = packed + runCount * frame->keyWidth;
+		char* runPids = runEnds + runCount * frame->runWidth;
+		char* deltas = runPids + runCount * frame->pidWidth;
+		char* sids = deltas + count * frame->deltaWidth;
+		for (int run = 0, start = 0, end; start < count; run++, start = end) {
+			PageId runPid = rids[start].pid;
+			for (end = start; end < count && keys[end] == keys[start]; end++)
+				runPid = min(runPid, rids[end].pid);
+			writePacked(packed, frame->keyWidth, run, (unsigned) keys[start] - (unsigned) frame->keyBase);
+			writePacked(runEnds, frame->runWidth, run, (unsigned) end);
+			writePacked(runPids, frame->pidWidth, run, (unsigned) runPid - (unsigned) frame->pidBase);
+			for (int i = start; i < end; i++) {
+				writePacked(deltas, frame->deltaWidth, i, (unsigned) rids[i].pid - (unsigned) runPid);
+				writePacked(sids, frame->sidWidth, i, (unsigned) rids[i].sid);
+			}
+		}
+	}
+
+	dirty = false;
+	return 0;
+}
+
+/*
+ * Get a pointer to the frame of reference behind the sibling PageIds
+ */
+BTLeafNode::Frame* BTLeafNode::getFrame()
+{
+	return (Frame*) (buffer + sizeof(NodeHeader) + 2 * sizeof(PageId));
+}
+
+/*
+ * Get a pointer to the packed entries of the node behind the frame
+ */
+char* BTLeafNode::getPacked()
+{
+	return buffer + sizeof(NodeHeader) + 2 * sizeof(PageId) + sizeof(Frame);
+}
+
+/*
+ * Get a pointer to the next sibling PageId behind the node header
  */
 PageId* BTLeafNode::getPageIDStart()
 {
-	return (PageId*) buffer;
+	return (PageId*) (buffer + sizeof(NodeHeader));
 }
 
 /* Print the contents of the nodes for debugging
  */
 void BTLeafNode::printNode()
 {
-	Entry* entry = (Entry*) getEntryStart();
+	decode();
 	cout << "[pageId|key|...|key]" << endl;
 	cout << "[" << *(getPageIDStart()) << "|";
-	for (int i = 0; i < getKeyCount(); i++, entry++)
+	for (int i = 0; i < getKeyCount(); i++)
 	{
-		cout << entry->key;
+		cout << keys[i];
 		if (i+1 != getKeyCount())
 			cout << "|";
 	}
@@ -273,6 +786,22 @@ void BTLeafNode::printNode()
 
 // START: BTNONLeafNode
 
+/*
+ * Compute the Eytzinger order of n sorted entries: order[k] is the sorted
+ * position of the entry stored at index k (1 to n) of the page, so that
+ * the children of index k are at 2k and 2k+1, as in a binary heap.
+ * @return the sorted position of the next entry to place
+ */
+static int eytzingerOrder(int* order, int i, int k, int n)
+{
+	if (k <= n) {
+		i = eytzingerOrder(order, i, 2 * k, n);
+		order[k] = i++;
+		i = eytzingerOrder(order, i, 2 * k + 1, n);
+	}
+	return i;
+}
+
 /*
  * Read the content of the node from the page pid in the PageFile pf.
  * @param pid[IN] the PageId to read
@@ -282,22 +811,30 @@ void BTLeafNode::printNode()
 
 BTNonLeafNode::BTNonLeafNode()
 {
-	std::fill(buffer, buffer + PageFile::PAGE_SIZE, 0);
+	initHeader(buffer, NodeHeader::NON_LEAF);
+	decoded = dirty = true;
 }
 
 RC BTNonLeafNode::read(PageId pid, const PageFile& pf)
 {
-	return pf.read(pid, buffer);
+	RC errorMsg = pf.read(pid, buffer);
+	decoded = dirty = false;
+	if (errorMsg != 0)
+		return errorMsg;
+	return checkHeader(buffer, NodeHeader::NON_LEAF);
 }
-    
+
 /*
  * Write the content of the node to the page pid in the PageFile pf.
+ * A node that has been changed is laid out in Eytzinger order again first.
  * @param pid[IN] the PageId to write to
  * @param pf[IN] PageFile to write to
  * @return 0 if successful. Return an error code if there is an error.
  */
 RC BTNonLeafNode::write(PageId pid, PageFile& pf)
 {
+	if (dirty)
+		encode();
 	return pf.write(pid, buffer);
 }
 
@@ -307,16 +844,7 @@ RC BTNonLeafNode::write(PageId pid, PageFile& pf)
  */
 int BTNonLeafNode::getKeyCount()
 {
-	int count = 0;
-	Entry* entry = (Entry*) getEntryStart();
-	for(int i = 0; i < MAX_NON_LEAF_ENTRIES; i++)
-	{
-		if (entry->key == 0)
-			break;
-		count++;
-		entry++;
-	}
-	return count;
+	return ((NodeHeader*) buffer)->keyCount;
 }
 
 /**
@@ -327,7 +855,9 @@ RC BTNonLeafNode::setKeyCount(int number)
 {
 	if (number < 0 || number > MAX_NON_LEAF_ENTRIES)
 		return RC_INVALID_CURSOR;
-	keyCount = number;
+	decode();
+	((NodeHeader*) buffer)->keyCount = number;
+	dirty = true;
 	return 0;
 }
 
@@ -335,132 +865,153 @@ RC BTNonLeafNode::setKeyCount(int number)
  * Insert a (key, pid) pair to the node.
  * @param key[IN] the key to insert
  * @param pid[IN] the PageId to insert
+ * @param left[IN] the child node that pid was split from
  * @return 0 if successful. Return an error code if the node is full.
  */
-RC BTNonLeafNode::insert(int key, PageId pid)
+RC BTNonLeafNode::insert(int key, PageId pid, PageId left)
 {
 	// If the node is full, return RC_NODE_FULL
-	if (getKeyCount() >= MAX_NON_LEAF_ENTRIES)
+	int count = getKeyCount();
+	if (count >= MAX_NON_LEAF_ENTRIES)
 		return RC_NODE_FULL;
+	decode();
 
 	// This is needed for initializeRoot
-	if (getKeyCount() == 0)
+	if (count == 0)
 	{
-		Entry* entry = (Entry*) getEntryStart();
-		entry->key = key;
-		entry->pid = pid;
+		keys[0] = key;
+		pids[0] = pid;
 	}
-	// Regular cases. We have to shift everything to the right
-	// so that we can insert our element at the right position
+	// Regular cases. We shift the keys from the position on and the pids
+	// behind it to the right, and put the new pid right of the new key
 	else
 	{
-		// get the position
-		int pos = insertPosition(key);
-		Entry* entry = (Entry*) getEntryStart() + getKeyCount() + 1;
-		Entry* prevEntry = entry - 1;
-		// shift the right most pid manually
-		entry->pid = prevEntry->pid;
-		entry--;
-		prevEntry--;
-		// the position of entry that we want to insert in
-		Entry* newEntry = (Entry*) getEntryStart() + pos;
-		// shift everything to the right
-		for (; prevEntry >= newEntry; entry--, prevEntry--)
-		{
-			entry->key = prevEntry->key;
-			entry->pid = prevEntry->pid;
-		}
-		// insert our new key and pid
-		newEntry->key = key;
-		newEntry->pid = pid;
-
-		PageId temp = newEntry->pid;
-		newEntry->pid = (newEntry + 1)->pid;
-		(newEntry + 1)->pid = temp;
+		int pos = insertPosition(key, left);
+		memmove(keys + pos + 1, keys + pos, (count - pos) * sizeof(int));
+		memmove(pids + pos + 2, pids + pos + 1, (count - pos) * sizeof(PageId));
+		keys[pos] = key;
+		pids[pos + 1] = pid;
 	}
-	return 0;
+	return setKeyCount(count + 1);
 }
 
 /*
  * Insert the (key, pid) pair to the node
- * and split the node half and half with sibling.
+ * and split the node with sibling.
+ * The node is split half and half, except at the edges: a new key behind
+ * all others leaves the node 90% full, and one before all others leaves
+ * the sibling 90% full.
  * The middle key after the split is returned in midKey.
  * @param key[IN] the key to insert
  * @param pid[IN] the PageId to insert
+ * @param left[IN] the child node that pid was split from
  * @param sibling[IN] the sibling node to split with. This node MUST be empty when this function is called.
  * @param midKey[OUT] the key in the middle after the split. This key should be inserted to the parent node.
  * @return 0 if successful. Return an error code if there is an error.
  */
-RC BTNonLeafNode::insertAndSplit(int key, PageId pid, BTNonLeafNode& sibling, int& midKey)
+RC BTNonLeafNode::insertAndSplit(int key, PageId pid, PageId left, BTNonLeafNode& sibling, int& midKey)
 {
     int oldKeyCount = getKeyCount();
     if (oldKeyCount < MAX_NON_LEAF_ENTRIES)
         return RC_INVALID_CURSOR; // node is not full, does not need to be split
     if (sibling.getKeyCount() != 0)
         return RC_INVALID_CURSOR; // sibling node must be empty
-    int pos = insertPosition(key); // find relative position of where our insertion should be
-    bool insertIntoCurrent = false;
-    double halfwayEntry = ((double) (oldKeyCount-1)) /2.0;
-    int newKeyCount = 0;
-    if (((double) pos) <= halfwayEntry) // insert into current node
-    {
-        newKeyCount = ((int) floor(((double) oldKeyCount)/2.0));
-        insertIntoCurrent = true;
-    }
-    else // insert into sibling node
-    {
-        newKeyCount = ((int) ceil(((double) oldKeyCount)/2.0));
-    }
-    // copy half of our values into sibling node
-    int siblingKeyCount = (MAX_NON_LEAF_ENTRIES - newKeyCount);
-    memcpy((Entry*)sibling.getEntryStart(), (Entry*) getEntryStart() + newKeyCount, siblingKeyCount * sizeof(Entry) + sizeof(PageId) );
-    if (insertIntoCurrent)
-    {
-        // get the position right after the last entry and right PageId
-        int* lastEntry = ((int*)((Entry*) getEntryStart() + newKeyCount))+1;
-        // delete all entries we copied to sibling
-        memset(lastEntry, '\0', siblingKeyCount * sizeof(Entry) + sizeof(PageId));
-        if (insert(key, pid) == RC_NODE_FULL)
-            return RC_NODE_FULL;
-        newKeyCount = getKeyCount();
-        midKey = ((Entry*) getEntryStart()+newKeyCount-1)->key; // needs to be moved up to parent node
-        // delete last entry we are moving up
-        lastEntry = ((int*)((Entry*) getEntryStart() + newKeyCount-1))+1;
-        memset(lastEntry, '\0', sizeof(Entry));
-    }
-    else
-    {
-        if (sibling.insert(key, pid) == RC_NODE_FULL)
-            return RC_NODE_FULL;
-        /*
-        midKey = ((Entry*)sibling.getEntryStart())->key; // needs to be moved up to parent node
-        memcpy((Entry*)getEntryStart()+newKeyCount, (Entry*)sibling.getEntryStart(), sizeof(PageId)); // copy the PageId from midKey
-        // shift all entries to the left one entry to overwrite midKey
-        memmove((Entry*)sibling.getEntryStart(), ((Entry*)sibling.getEntryStart())+1, (siblingKeyCount) * sizeof(Entry) + sizeof(PageId));
-        // get the position right before the last entry after its left PageId
-        int* siblingLastEntry = ((int*)((Entry*) sibling.getEntryStart() + siblingKeyCount+1))+1;
-        // zero out last entry in sibling
-        memset(siblingLastEntry, '\0', sizeof(Entry));
-        // get the position right after the last entry and right PageId
-        int* lastEntry = ((int*)((Entry*) getEntryStart() + newKeyCount))+1;
-        // clear copied entries in other node
-        memset(lastEntry, '\0', siblingKeyCount * sizeof(Entry) + sizeof(PageId));
-        */
-
-		// get the position right after the last entry and right PageId
-        int* lastEntry = ((int*)((Entry*) getEntryStart() + newKeyCount))+1;
-        // delete all entries we copied to sibling
-        memset(lastEntry, '\0', siblingKeyCount * sizeof(Entry) + sizeof(PageId));
-        midKey = ((Entry*) getEntryStart()+newKeyCount-1)->key; // needs to be moved up to parent node
-        // delete last entry we are moving up
-        lastEntry = ((int*)((Entry*) getEntryStart() + newKeyCount-1))+1;
-        memset(lastEntry, '\0', sizeof(Entry));
-
-    }
-	
+    int pos = insertPosition(key, left); // find relative position of where our insertion should be
+
+    // put all keys and pids, the new ones included, in one sorted list.
+    // the new pid goes right of the new key.
+    int count = oldKeyCount + 1;
+    int allKeys[MAX_NON_LEAF_ENTRIES + 1];
+    PageId allPids[MAX_NON_LEAF_ENTRIES + 2];
+    memcpy(allKeys, keys, pos * sizeof(int));
+    memcpy(allPids, pids, (pos + 1) * sizeof(PageId));
+    allKeys[pos] = key;
+    allPids[pos + 1] = pid;
+    memcpy(allKeys + pos + 1, keys + pos, (oldKeyCount - pos) * sizeof(int));
+    memcpy(allPids + pos + 2, pids + pos + 1, (oldKeyCount - pos) * sizeof(PageId));
+
+    // this node keeps the keys left of the middle key, and the sibling the
+    // ones right of it. both keep at least one key.
+    int newKeyCount = min(nodeSplitPoint(count, pos), count - 2);
+    int siblingKeyCount = count - newKeyCount - 1;
+    memcpy(keys, allKeys, newKeyCount * sizeof(int));
+    memcpy(pids, allPids, (newKeyCount + 1) * sizeof(PageId));
+    memcpy(sibling.keys, allKeys + newKeyCount + 1, siblingKeyCount * sizeof(int));
+    memcpy(sibling.pids, allPids + newKeyCount + 1, (siblingKeyCount + 1) * sizeof(PageId));
+    setKeyCount(newKeyCount);
+    sibling.setKeyCount(siblingKeyCount);
+
+    // the middle key moves up to the parent node.
+    // its right pid is the left most pid of the sibling.
+    midKey = allKeys[newKeyCount];
+
+	return 0;
+}
+
+/*
+ * Find the right neighbour of a child node and the key between the two.
+ * @param pid[IN] the PageId of the child node
+ * @param sibling[OUT] the PageId of the child right of it
+ * @param eid[OUT] the position of the key between the two children
+ * @return 0 if successful. RC_NO_SUCH_RECORD if pid is not a child of
+ * the node or is the right most one.
+ */
+RC BTNonLeafNode::locateRightSibling(PageId pid, PageId& sibling, int& eid)
+{
+	decode();
+	int count = getKeyCount();
+	for (int i = 0; i < count; i++)
+	{
+		if (pids[i] == pid)
+		{
+			sibling = pids[i + 1];
+			eid = i;
+			return 0;
+		}
+	}
+	return RC_NO_SUCH_RECORD;
+}
+
+/*
+ * Change the key at position eid. The keys must stay sorted.
+ * @param eid[IN] the position of the key
+ * @param key[IN] the new key
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTNonLeafNode::setKey(int eid, int key)
+{
+	if (eid < 0 || eid >= getKeyCount())
+		return RC_INVALID_CURSOR;
+	decode();
+	keys[eid] = key;
+	dirty = true;
 	return 0;
 }
 
+/*
+ * Fill the empty node with the first children of a level of the tree, as
+ * many as nodeFillCount() gives. The key of the first child is the one
+ * left of the node in its parent.
+ * @param childKeys[IN] the first key of each child. The first one is not stored
+ * @param childPids[IN] the PageIds of the children, in key order
+ * @param count[IN] the number of children, at least two
+ * @param fillPercent[IN] how full the node should be, from 1 to 100
+ * @param taken[OUT] the number of children stored in the node
+ * @return 0 if successful. RC_INVALID_CURSOR if the node is not empty.
+ */
+RC BTNonLeafNode::fill(const int* childKeys, const PageId* childPids, int count,
+                       int fillPercent, int& taken)
+{
+	if (getKeyCount() != 0 || count < 2)
+		return RC_INVALID_CURSOR;
+	decode();
+
+	taken = nodeFillCount(count, MAX_NON_LEAF_ENTRIES, fillPercent);
+	memcpy(keys, childKeys + 1, (taken - 1) * sizeof(int));
+	memcpy(pids, childPids, taken * sizeof(PageId));
+	return setKeyCount(taken - 1);
+}
+
 /*
  * Given the searchKey, find the child-node pointer to follow and
  * output it in pid.
@@ -470,29 +1021,73 @@ RC BTNonLeafNode::insertAndSplit(int key, PageId pid, BTNonLeafNode& sibling, in
  */
 RC BTNonLeafNode::locateChildPtr(int searchKey, PageId& pid)
 {
-	Entry* entry = (Entry*) getEntryStart();
-	// if the searchKey is smaller than our first key, return the left pointer of our first key
-	if (entry->key > searchKey)
-	{
-		pid = entry->pid;
+	// follow the pid left of the first key larger than searchKey,
+	// or the right most pid if there is no such key
+	if (decoded) {
+		pid = pids[insertPosition(searchKey)];
 		return 0;
 	}
-	// Otherwise, find the position and return the correct pid
-	for (int i = 0; i < getKeyCount() && entry->key <= searchKey; i++, entry++) {}
-	pid = entry->pid;
+
+	// walk down the Eytzinger layout of the page: the children of index k
+	// are at 2k and 2k+1, so the keys compared four levels further down
+	// are next to each other and can be fetched ahead of time
+	const int* pageKeys = getKeys();
+	int count = getKeyCount();
+	int k = 1;
+	while (k <= count) {
+		if (16 * k <= count)
+			__builtin_prefetch(pageKeys + 16 * k);
+		k = 2 * k + (pageKeys[k] <= searchKey);
+	}
+	// undo the right turns taken after the last left turn. k is then the
+	// first key larger than searchKey, or 0 where the right most pid is.
+	k >>= __builtin_ffs(~k);
+	pid = getPageIds()[k];
 	return 0;
 }
 
-// return the position of the largest key that is smaller than key[IN]
+/*
+ * Find the child-node pointer to follow for the first entry with
+ * searchKey. A split may leave entries with a key equal to the separator
+ * in the left child, so this goes left on such a separator.
+ * @param searchKey[IN] the searchKey that is being looked up.
+ * @param pid[OUT] the pointer to the child node to follow.
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTNonLeafNode::locateLeftChildPtr(int searchKey, PageId& pid)
+{
+	return locateChildPtr(searchKey == INT_MIN ? searchKey : searchKey - 1, pid);
+}
+
+/*
+ * Return the pointer to the left most child node.
+ * @return the PageId of the left most child node
+ */
+PageId BTNonLeafNode::getFirstChildPtr()
+{
+	decode();
+	return pids[0];
+}
+
+// return the position of the first key that is larger than key[IN]
 int BTNonLeafNode::insertPosition(int key)
 {
-	Entry* entry = (Entry*) getEntryStart();
-	for (int i = 0; i < getKeyCount(); i++, entry++)
-	{
-		if (key < entry->key)
-			return i;
-	}
-	return getKeyCount();
+	decode();
+	return countKeys(keys, getKeyCount(), key, true);
+}
+
+// return the position of a new key whose pid goes right of the child left.
+// the children between keys equal to key may hold key as well, so the new
+// key goes behind the smaller keys and the equal keys left of that child.
+int BTNonLeafNode::insertPosition(int key, PageId left)
+{
+	decode();
+	int count = getKeyCount();
+	int pos = countKeys(keys, count, key, false);
+	int last = countKeys(keys, count, key, true);
+	while (pos < last && pids[pos] != left)
+		pos++;
+	return pos;
 }
 
 /*
@@ -508,31 +1103,308 @@ RC BTNonLeafNode::initializeRoot(PageId pid1, int key, PageId pid2)
 	if (getKeyCount() != 0)
 		return RC_INVALID_CURSOR;
 	// insert our first element
-	insert(key, pid1);
-	Entry* entry = (Entry*) getEntryStart() + 1;
+	insert(key, pid1, pid1);
 	// insert pid
-	entry->pid = pid2;
+	pids[1] = pid2;
 	return 0;
 }
 
 /*
- * get a void pointer (needs to be converted) to the start of the entries in the node
+ * Read the sorted keys and pids from the Eytzinger layout of the page.
+ */
+void BTNonLeafNode::decode()
+{
+	if (decoded)
+		return;
+	int count = getKeyCount();
+	int order[MAX_NON_LEAF_ENTRIES + 1];
+	eytzingerOrder(order, 0, 1, count);
+	const int* pageKeys = getKeys();
+	const PageId* pagePids = getPageIds();
+	for (int k = 1; k <= count; k++) {
+		keys[order[k]] = pageKeys[k];
+		pids[order[k]] = pagePids[k];
+	}
+	pids[count] = pagePids[0];
+	decoded = true;
+}
+
+/*
+ * Lay out the sorted keys and pids in the page in Eytzinger order.
+ * Index k of the page holds a key and the pid left of it; the right most
+ * pid takes index 0, where the search ends when no key is larger.
  */
-char* BTNonLeafNode::getEntryStart()
+void BTNonLeafNode::encode()
 {
-	return (char*) buffer + sizeof(PageId);
+	int count = getKeyCount();
+	int order[MAX_NON_LEAF_ENTRIES + 1];
+	eytzingerOrder(order, 0, 1, count);
+	int* pageKeys = getKeys();
+	PageId* pagePids = getPageIds();
+	memset(pageKeys, 0, (MAX_NON_LEAF_ENTRIES + 1) * sizeof(int));
+	memset(pagePids, 0, (MAX_NON_LEAF_ENTRIES + 1) * sizeof(PageId));
+	for (int k = 1; k <= count; k++) {
+		pageKeys[k] = keys[order[k]];
+		pagePids[k] = pids[order[k]];
+	}
+	pagePids[0] = pids[count];
+	dirty = false;
+}
+
+/*
+ * Get a pointer to the keys of the node behind the node header.
+ * Index 0 is not used by the keys
+ */
+int* BTNonLeafNode::getKeys()
+{
+	return (int*) (buffer + sizeof(NodeHeader));
+}
+
+/*
+ * Get a pointer to the child PageIds of the node behind the keys
+ */
+PageId* BTNonLeafNode::getPageIds()
+{
+	return (PageId*) (getKeys() + MAX_NON_LEAF_ENTRIES + 1);
 }
 
 /* Print the contents of the nodes for debugging
  */
 void BTNonLeafNode::printNode()
 {
-	Entry* entry = (Entry*) getEntryStart();
+	decode();
 	cout << "[pageId,key|...|pageId]" << endl;
 	cout << "[";
-	for (int i = 0; i < getKeyCount(); i++, entry++)
+	for (int i = 0; i < getKeyCount(); i++)
 	{
-		cout << entry->pid << "," << entry->key << "|";
+		cout << pids[i] << "," << keys[i] << "|";
 	}
-	cout << entry->pid << "]" << endl;
+	cout << pids[getKeyCount()] << "]" << endl;
+}
+
+/*
+ * Default Constructor for a BTRecordNode
+ */
+BTRecordNode::BTRecordNode()
+{
+	initHeader(buffer, NodeHeader::RECORD);
+}
+
+/*
+ * Read the content of the node from the page pid in the PageFile pf.
+ * @param pid[IN] the PageId to read
+ * @param pf[IN] PageFile to read from
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::read(PageId pid, const PageFile& pf)
+{
+	RC errorMsg = pf.read(pid, buffer);
+	if (errorMsg != 0)
+		return errorMsg;
+	return checkHeader(buffer, NodeHeader::RECORD);
+}
+
+/*
+ * Write the content of the node to the page pid in the PageFile pf.
+ * @param pid[IN] the PageId to write to
+ * @param pf[IN] PageFile to write to
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::write(PageId pid, PageFile& pf)
+{
+	return pf.write(pid, buffer);
+}
+
+/*
+ * Return the number of keys stored in the node.
+ * @return the number of keys in the node
+ */
+int BTRecordNode::getKeyCount()
+{
+	return ((NodeHeader*) buffer)->keyCount;
+}
+
+// set the number of keys stored in the node
+void BTRecordNode::setKeyCount(int number)
+{
+	((NodeHeader*) buffer)->keyCount = number;
+}
+
+// get a pointer to the keys of the node behind the next sibling PageId
+int* BTRecordNode::getKeys()
+{
+	return (int*) (buffer + sizeof(NodeHeader) + sizeof(PageId));
+}
+
+// get a pointer to the value of the eid entry. the values follow the keys.
+char* BTRecordNode::getValue(int eid)
+{
+	return (char*) (getKeys() + MAX_RECORD_ENTRIES) + eid * RecordFile::MAX_VALUE_LENGTH;
+}
+
+/*
+ * Return the pid of the next slibling node.
+ * @return the PageId of the next sibling node
+ */
+PageId BTRecordNode::getNextNodePtr()
+{
+	PageId pid;
+	memcpy(&pid, buffer + sizeof(NodeHeader), sizeof(PageId));
+	return pid;
+}
+
+/*
+ * Set the next slibling node PageId.
+ * @param pid[IN] the PageId of the next sibling node
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::setNextNodePtr(PageId pid)
+{
+	memcpy(buffer + sizeof(NodeHeader), &pid, sizeof(PageId));
+	return 0;
+}
+
+/*
+ * Set eid to the first entry whose key is not smaller than searchKey,
+ * or to the number of entries if there is no such entry.
+ * @param searchKey[IN] the key to search for.
+ * @param eid[OUT] the entry number of the first key >= searchKey.
+ * @return 0 if searchKey is found. If not, RC_NO_SUCH_RECORD.
+ */
+RC BTRecordNode::locate(int searchKey, int& eid)
+{
+	int count = getKeyCount();
+	eid = countKeys(getKeys(), count, searchKey, false);
+	if (eid < count && getKeys()[eid] == searchKey)
+		return 0;
+	return RC_NO_SUCH_RECORD;
+}
+
+/*
+ * Insert the (key, value) pair to the node, behind the entries
+ * with the same key.
+ * @param key[IN] the key to insert
+ * @param value[IN] the value to insert
+ * @return 0 if successful. Return an error code if the node is full.
+ */
+RC BTRecordNode::insert(int key, const string& value)
+{
+	int count = getKeyCount();
+	if (count >= MAX_RECORD_ENTRIES)
+		return RC_NODE_FULL;
+
+	// find the first entry with a larger key and shift the rest to the right
+	int eid = countKeys(getKeys(), count, key, true);
+	memmove(getKeys() + eid + 1, getKeys() + eid, (count - eid) * sizeof(int));
+	memmove(getValue(eid + 1), getValue(eid), (count - eid) * RecordFile::MAX_VALUE_LENGTH);
+
+	getKeys()[eid] = key;
+	setKeyCount(count + 1);
+	return setValue(eid, value);
+}
+
+/*
+ * Insert the (key, value) pair to the node
+ * and split the node with sibling: half and half, or 90/10 when the new
+ * entry goes before or behind all others.
+ * The first key of the sibling node is returned in siblingKey.
+ * @param key[IN] the key to insert.
+ * @param value[IN] the value to insert.
+ * @param sibling[IN] the sibling node to split with. This node MUST be EMPTY when this function is called.
+ * @param siblingKey[OUT] the first key in the sibling node after split.
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::insertAndSplit(int key, const string& value,
+                                BTRecordNode& sibling, int& siblingKey)
+{
+	int count = getKeyCount();
+	if (count < MAX_RECORD_ENTRIES)
+		return RC_INVALID_CURSOR; // node is not full, does not need to be split
+	if (sibling.getKeyCount() != 0)
+		return RC_INVALID_CURSOR; // sibling node must be empty
+
+	// the new entry goes behind the entries with the same key. the node
+	// keeps half of the entries, the new one included, or 90% of them
+	// when the new one is at an edge.
+	int pos = countKeys(getKeys(), count, key, true);
+	int half = nodeSplitPoint(count + 1, pos);
+	bool insertIntoCurrent = (pos < half);
+	if (insertIntoCurrent)
+		half--;
+
+	// move the entries behind half to the sibling
+	memcpy(sibling.getKeys(), getKeys() + half, (count - half) * sizeof(int));
+	memcpy(sibling.getValue(0), getValue(half), (count - half) * RecordFile::MAX_VALUE_LENGTH);
+	memset(getKeys() + half, 0, (count - half) * sizeof(int));
+	memset(getValue(half), 0, (count - half) * RecordFile::MAX_VALUE_LENGTH);
+	sibling.setKeyCount(count - half);
+	setKeyCount(half);
+	sibling.setNextNodePtr(getNextNodePtr());
+	// current node's nextPointer needs to be set in the function that calls this during sibling node creation
+
+	RC errorMsg;
+	if (insertIntoCurrent)
+		errorMsg = insert(key, value);
+	else
+		errorMsg = sibling.insert(key, value);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	siblingKey = sibling.getKeys()[0]; // needs to be used to set parent node pointer
+	return 0;
+}
+
+/*
+ * Read the (key, value) pair from the eid entry.
+ * @param eid[IN] the entry number to read
+ * @param key[OUT] the key from the entry
+ * @param value[OUT] the value from the entry
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::readEntry(int eid, int& key, string& value)
+{
+	if (eid < 0 || eid >= getKeyCount())
+		return RC_INVALID_CURSOR;
+
+	char* v = getValue(eid);
+	key = getKeys()[eid];
+	value.assign(v, strnlen(v, RecordFile::MAX_VALUE_LENGTH));
+	return 0;
+}
+
+/*
+ * Change the value of the eid entry.
+ * @param eid[IN] the entry number to change
+ * @param value[IN] the new value of the entry
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::setValue(int eid, const string& value)
+{
+	if (eid < 0 || eid >= getKeyCount())
+		return RC_INVALID_CURSOR;
+
+	// values are truncated as in RecordFile
+	char* v = getValue(eid);
+	memset(v, 0, RecordFile::MAX_VALUE_LENGTH);
+	strncpy(v, value.c_str(), RecordFile::MAX_VALUE_LENGTH - 1);
+	return 0;
+}
+
+/*
+ * Remove the eid entry from the node, shifting the entries behind it.
+ * @param eid[IN] the entry number to remove
+ * @return 0 if successful. Return an error code if there is an error.
+ */
+RC BTRecordNode::remove(int eid)
+{
+	int count = getKeyCount();
+	if (eid < 0 || eid >= count)
+		return RC_INVALID_CURSOR;
+
+	memmove(getKeys() + eid, getKeys() + eid + 1, (count - eid - 1) * sizeof(int));
+	memmove(getValue(eid), getValue(eid + 1), (count - eid - 1) * RecordFile::MAX_VALUE_LENGTH);
+	getKeys()[count - 1] = 0;
+	memset(getValue(count - 1), 0, RecordFile::MAX_VALUE_LENGTH);
+	setKeyCount(count - 1);
+	return 0;
 }
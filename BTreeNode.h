@@ -12,23 +12,107 @@
 
 #include "RecordFile.h"
 #include "PageFile.h"
+#include <algorithm>
+
+/**
+ * NodeHeader: the header at the start of every B+tree node page.
+ * The number of keys is stored in the header, so it is known without
+ * looking at the entries and a key may have any value, 0 included.
+ */
+struct NodeHeader {
+    // the format of the nodes written by this version of Bruinbase
+    static const char VERSION = 6;
+    // the kinds of nodes. the nodes of a generic BTree (see BTree.h)
+    // store the size of their key in flags.
+    enum Type { LEAF = 1, NON_LEAF = 2, RECORD = 3, GENERIC_LEAF = 4, GENERIC_NON_LEAF = 5 };
+
+    char  version;   // the format the node was written in
+    char  type;      // the Type of the node
+    short flags;     // the key size of generic nodes. 0 for the others
+    int   keyCount;  // the number of keys in the node
+};
+
+/*
+ * The number of entries the left node keeps when count entries, a new one
+ * at position pos included, are split into two nodes. Inserts tend to go
+ * on at the same place, so a new entry behind all others leaves the left
+ * node 90% full, as when keys arrive in increasing order, and one before
+ * all others leaves the right node 90% full. Other splits are half and half.
+ */
+inline int nodeSplitPoint(int count, int pos)
+{
+    if (pos == count - 1)
+        return count - std::max(1, count / 10);
+    if (pos == 0)
+        return std::max(1, count / 10);
+    return count / 2;
+}
+
+/*
+ * The number of children that a nonleaf node built bottom up takes out
+ * of the count children left on its level: enough for fillPercent percent
+ * of maxKeys keys, but never leaving a single child for the next node.
+ */
+inline int nodeFillCount(int count, int maxKeys, int fillPercent)
+{
+    int n = std::min(maxKeys, std::max(3, maxKeys * fillPercent / 100)) + 1;
+    if (n >= count)
+        return count;
+    return (count - n == 1) ? n - 1 : n;
+}
 
 /**
  * BTLeafNode: The class representing a B+tree leaf node.
+ * The page starts with the NodeHeader, the PageIds of the next and the
+ * previous sibling nodes and a Frame, followed by the entries in compressed form: the keys as
+ * offsets from the smallest key, then the PageIds of the RecordIds as
+ * offsets from the smallest PageId, then the slot ids. Each of the three
+ * arrays uses 1, 2 or 4 bytes per entry, as few as its largest value needs,
+ * so a leaf of dense keys pointing to nearby records holds about three
+ * times as many entries as with plain keys and RecordIds.
+ *
+ * Entries of the same key are sorted by RecordId. When that is smaller,
+ * they are stored as posting lists instead: each run of equal keys keeps
+ * its key offset, the end of the run and its smallest PageId offset once,
+ * and each entry only the distance of its PageId from that one and its
+ * slot id. A key with more entries than a node holds goes on in the next
+ * leaves, and an equality search reads them all after one descent.
+ *
+ * A node read from the disk is searched and read in the page itself;
+ * locate() and readEntry() only decode the entries they look at. The
+ * entries are decoded in full when the node is changed, and encoded again
+ * when it is written.
  */
 class BTLeafNode {
   public:
-    // Size of one leaf entry. RecordId and key are stored
-    static const int LEAF_ENTRY_SIZE = sizeof(RecordId) + sizeof(int);
+    /**
+     * Frame: the frame of reference of the entries of a leaf.
+     */
+    struct Frame {
+        int    keyBase;     // the smallest key of the node
+        PageId pidBase;     // the smallest PageId of the RecordIds
+        char   keyWidth;    // the bytes of each key offset
+        char   pidWidth;    // the bytes of each PageId offset
+        char   sidWidth;    // the bytes of each slot id
+        char   runWidth;    // the bytes of each run end. 0 if the entries are stored flat
+        char   deltaWidth;  // the bytes of each PageId distance in a run
+        char   unused;
+        short  runCount;    // the number of runs of equal keys
+    };
+    // Bytes of the page that hold the compressed entries
+    static const int PACKED_SIZE = PageFile::PAGE_SIZE - sizeof(NodeHeader) - 2 * sizeof(PageId) - sizeof(Frame);
+    // Size of the smallest leaf entry. 1-byte PageId distance and slot id in a run
+    static const int LEAF_ENTRY_SIZE = 2;
     // Maximum number of entries that a leaf node can have.
-    static const int MAX_LEAF_ENTRIES = (PageFile::PAGE_SIZE - sizeof(PageId)) / LEAF_ENTRY_SIZE;
+    static const int MAX_LEAF_ENTRIES = PACKED_SIZE / LEAF_ENTRY_SIZE;
 
     // Constructor for BTLeafNode();
     BTLeafNode();
 
    /**
     * Insert the (key, rid) pair to the node.
-    * Remember that all keys inside a B+tree node should be kept sorted.
+    * Remember that all keys inside a B+tree node should be kept sorted,
+    * and the entries of the same key by their RecordIds.
     * @param key[IN] the key to insert
     * @param rid[IN] the RecordId to insert
     * @return 0 if successful. Return an error code if the node is full.
@@ -37,7 +121,8 @@ class BTLeafNode {
 
    /**
     * Insert the (key, rid) pair to the node
-    * and split the node half and half with sibling.
+    * and split the node with sibling: half and half, or 90/10 when the
+    * new entry goes before or behind all others.
     * The first key of the sibling node is returned in siblingKey.
     * Remember that all keys inside a B+tree node should be kept sorted.
     * @param key[IN] the key to insert.
@@ -48,6 +133,39 @@ class BTLeafNode {
     */
     RC insertAndSplit(int key, const RecordId& rid, BTLeafNode& sibling, int& siblingKey);
 
+   /**
+    * Insert the (key, rid) pair to the node and move entries between
+    * the node and its right sibling, so that both hold about half of them.
+    * The first key of the sibling node after the move is returned in siblingKey.
+    * @param key[IN] the key to insert. It must be smaller than the first key of sibling.
+    * @param rid[IN] the RecordId to insert.
+    * @param sibling[IN/OUT] the next node under the same parent.
+    * @param siblingKey[OUT] the first key in the sibling node after the move.
+    * @return 0 if successful. RC_NODE_FULL if the entries do not fit in the two nodes.
+    */
+    RC insertAndRedistribute(int key, const RecordId& rid, BTLeafNode& sibling, int& siblingKey);
+
+   /**
+    * Fill the empty node with the first entries of a sorted list, as many
+    * as fit in fillPercent percent of the page, and at least one.
+    * @param allKeys[IN] the keys of the entries, sorted
+    * @param allRids[IN] the RecordIds of the entries, sorted within a key
+    * @param count[IN] the number of entries in the list
+    * @param fillPercent[IN] how full the node should be, from 1 to 100
+    * @param taken[OUT] the number of entries stored in the node
+    * @return 0 if successful. RC_INVALID_CURSOR if the node is not empty.
+    */
+    RC fill(const int* allKeys, const RecordId* allRids, int count, int fillPercent, int& taken);
+
+   /**
+    * Set eid to the last entry whose key is not larger than searchKey,
+    * or to -1 if there is no such entry.
+    * @param searchKey[IN] the key to search for.
+    * @param eid[OUT] the entry number of the last key <= searchKey.
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC locateLast(int searchKey, int& eid);
+
    /**
     * If searchKey exists in the node, set eid to the index entry
     * with searchKey and return 0. If not, set eid to the index entry
@@ -70,6 +188,22 @@ class BTLeafNode {
     */
     RC readEntry(int eid, int& key, RecordId& rid);
 
+   /**
+    * Remove the eid entry from the node, shifting the entries behind it.
+    * @param eid[IN] the entry number to remove
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC remove(int eid);
+
+   /**
+    * Change the RecordId of the eid entry. The entry may move among the
+    * entries of the same key, which are sorted by RecordId.
+    * @param eid[IN] the entry number to change
+    * @param rid[IN] the new RecordId of the entry
+    * @return 0 if successful. RC_NODE_FULL if the entries do not fit with the new RecordId.
+    */
+    RC setPayload(int eid, const RecordId& rid);
+
    /**
     * Return the pid of the next slibling node.
     * @return the PageId of the next sibling node 
@@ -84,6 +218,19 @@ class BTLeafNode {
     */
     RC setNextNodePtr(PageId pid);
 
+   /**
+    * Return the pid of the previous sibling node.
+    * @return the PageId of the previous sibling node. 0 for the first node
+    */
+    PageId getPrevNodePtr();
+
+   /**
+    * Set the previous sibling node PageId.
+    * @param pid[IN] the PageId of the previous sibling node
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC setPrevNodePtr(PageId pid);
+
    /**
     * Return the number of keys stored in the node.
     * @return the number of keys in the node
@@ -97,12 +244,7 @@ class BTLeafNode {
     RC setKeyCount(int number);
  
     /*
-    * get a void pointer (needs to be converted) to the start of the entries in the node
-    */
-    char* getEntryStart();
-
-    /*
-    * Get a pointer to the start of the node
+    * Get a pointer to the next sibling PageId behind the node header
     */
     PageId* getPageIDStart();
 
@@ -132,29 +274,53 @@ class BTLeafNode {
     * that contains the node.
     */
     char buffer[PageFile::PAGE_SIZE];
-    int keyCount;
-    // Memory address of PageId
-    PageId* pageIdStart;
-    // Struct to store an entry
-    struct Entry
-    {
-        RecordId rid;
-        int key;
-    };
-    // Memory address of where Entry starts
-    Entry* entryStart;
+
+    int      keys[MAX_LEAF_ENTRIES];  // the decoded keys of the entries
+    RecordId rids[MAX_LEAF_ENTRIES];  // the decoded RecordIds of the entries
+    bool keysDecoded;  // true if keys holds the keys of the node
+    bool ridsDecoded;  // true if rids holds the RecordIds of the node
+    bool dirty;        // true if the entries have changed since the page was encoded
+
+    // decode all entries of the page into keys and rids
+    void decode();
+
+    // encode keys and rids into the page
+    RC encode();
+
+    // return the position where the (key, rid) entry is inserted
+    int insertPosition(int key, const RecordId& rid);
+
+    // store sorted entries in the node and sibling, split close to target
+    RC distribute(const int* allKeys, const RecordId* allRids, int count,
+                  int target, BTLeafNode& sibling);
+
+    // get a pointer to the frame of reference of the node
+    Frame* getFrame();
+
+    // get a pointer to the compressed entries of the node
+    char* getPacked();
 };
 
 
 /**
  * BTNonLeafNode: The class representing a B+tree nonleaf node.
+ * The page starts with the NodeHeader, followed by the keys and then by
+ * the child PageIds, both in Eytzinger order: the keys form an implicit
+ * binary search tree where the children of index k are at 2k and 2k+1, so
+ * a search reads the page from the front and can prefetch the keys it
+ * compares next. The k-th PageId points to the child left of the k-th key,
+ * and the PageId at index 0 to the right most child.
+ *
+ * locateChildPtr() searches the page as it was read. The sorted keys and
+ * PageIds are decoded only when the node is changed, and laid out in
+ * Eytzinger order again when it is written.
  */
 class BTNonLeafNode {
   public:
     // Size of one leaf entry. RecordId and key are stored
     static const int NON_LEAF_ENTRY_SIZE = sizeof(PageId) + sizeof(int);
     // Maximum number of entries that a leaf node can have.
-    static const int MAX_NON_LEAF_ENTRIES = (PageFile::PAGE_SIZE - sizeof(PageId)) / NON_LEAF_ENTRY_SIZE;
+    static const int MAX_NON_LEAF_ENTRIES = (PageFile::PAGE_SIZE - sizeof(NodeHeader) - sizeof(PageId)) / NON_LEAF_ENTRY_SIZE;
     // Constructor for BTNonLeafNode();
     BTNonLeafNode();
    /**
@@ -162,23 +328,39 @@ class BTNonLeafNode {
     * Remember that all keys inside a B+tree node should be kept sorted.
     * @param key[IN] the key to insert
     * @param pid[IN] the PageId to insert
+    * @param left[IN] the child node that pid was split from. pid goes right
+    *                 of it when other keys are equal to key.
     * @return 0 if successful. Return an error code if the node is full.
     */
-    RC insert(int key, PageId pid);
+    RC insert(int key, PageId pid, PageId left);
 
    /**
     * Insert the (key, pid) pair to the node
-    * and split the node half and half with sibling.
+    * and split the node with sibling: half and half, or 90/10 when the
+    * new key goes before or behind all others.
     * The sibling node MUST be empty when this function is called.
     * The middle key after the split is returned in midKey.
     * Remember that all keys inside a B+tree node should be kept sorted.
     * @param key[IN] the key to insert
     * @param pid[IN] the PageId to insert
+    * @param left[IN] the child node that pid was split from
     * @param sibling[IN] the sibling node to split with. This node MUST be empty when this function is called.
     * @param midKey[OUT] the key in the middle after the split. This key should be inserted to the parent node.
     * @return 0 if successful. Return an error code if there is an error.
     */
-    RC insertAndSplit(int key, PageId pid, BTNonLeafNode& sibling, int& midKey);
+    RC insertAndSplit(int key, PageId pid, PageId left, BTNonLeafNode& sibling, int& midKey);
+
+   /**
+    * Fill the empty node with the first children of a level of the tree,
+    * as many as nodeFillCount() gives.
+    * @param childKeys[IN] the first key of each child. The first one is not stored
+    * @param childPids[IN] the PageIds of the children, in key order
+    * @param count[IN] the number of children, at least two
+    * @param fillPercent[IN] how full the node should be, from 1 to 100
+    * @param taken[OUT] the number of children stored in the node
+    * @return 0 if successful. RC_INVALID_CURSOR if the node is not empty.
+    */
+    RC fill(const int* childKeys, const PageId* childPids, int count, int fillPercent, int& taken);
 
    /**
     * Given the searchKey, find the child-node pointer to follow and
@@ -190,6 +372,39 @@ class BTNonLeafNode {
     */
     RC locateChildPtr(int searchKey, PageId& pid);
 
+   /**
+    * Find the child-node pointer to follow for the first entry with
+    * searchKey, going left on a separator equal to searchKey.
+    * @param searchKey[IN] the searchKey that is being looked up.
+    * @param pid[OUT] the pointer to the child node to follow.
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC locateLeftChildPtr(int searchKey, PageId& pid);
+
+   /**
+    * Return the pointer to the left most child node.
+    * @return the PageId of the left most child node
+    */
+    PageId getFirstChildPtr();
+
+   /**
+    * Find the right neighbour of a child node and the key between the two.
+    * @param pid[IN] the PageId of the child node
+    * @param sibling[OUT] the PageId of the child right of it
+    * @param eid[OUT] the position of the key between the two children
+    * @return 0 if successful. RC_NO_SUCH_RECORD if pid is not a child of
+    * the node or is the right most one.
+    */
+    RC locateRightSibling(PageId pid, PageId& sibling, int& eid);
+
+   /**
+    * Change the key at position eid. The keys must stay sorted.
+    * @param eid[IN] the position of the key
+    * @param key[IN] the new key
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC setKey(int eid, int key);
+
    /**
     * Initialize the root node with (pid1, key, pid2).
     * @param pid1[IN] the first PageId to insert
@@ -211,11 +426,6 @@ class BTNonLeafNode {
     */
     RC setKeyCount(int number);
 
-    /*
-    * get a void pointer (needs to be converted) to the start of the entries in the node
-    */
-    char* getEntryStart();
-
    /**
     * Read the content of the node from the page pid in the PageFile pf.
     * @param pid[IN] the PageId to read
@@ -244,13 +454,150 @@ class BTNonLeafNode {
     * that contains the node.
     */
     char buffer[PageFile::PAGE_SIZE];
-    int keyCount;
-    struct Entry
-    {
-        PageId pid;
-        int key;
-    };
-    Entry* entryStart;
+
+    int    keys[MAX_NON_LEAF_ENTRIES];      // the decoded keys, sorted
+    PageId pids[MAX_NON_LEAF_ENTRIES + 1];  // the decoded child PageIds
+    bool decoded;  // true if keys and pids hold the entries of the node
+    bool dirty;    // true if the entries have changed since the page was laid out
+
+    // return the position of a new key whose pid goes right of the child left
+    int insertPosition(int key, PageId left);
+
+    // decode the sorted keys and pids from the page
+    void decode();
+
+    // lay out keys and pids in the page in Eytzinger order
+    void encode();
+
+    // get a pointer to the keys of the node in the page
+    int* getKeys();
+
+    // get a pointer to the child PageIds of the node in the page
+    PageId* getPageIds();
 }; 
 
+/**
+ * BTRecordNode: The class representing a leaf node of an index-organized
+ * table. It stores the whole (key, value) tuple instead of a RecordId.
+ * The page starts with the NodeHeader and the PageId of the next
+ * sibling node, followed by the keys of the entries sorted by key and
+ * then by their values.
+ */
+class BTRecordNode {
+  public:
+    // Size of one entry. The key and the value are stored
+    static const int RECORD_ENTRY_SIZE = sizeof(int) + RecordFile::MAX_VALUE_LENGTH;
+    // Maximum number of entries that a node can have.
+    static const int MAX_RECORD_ENTRIES = (PageFile::PAGE_SIZE - sizeof(NodeHeader) - sizeof(PageId)) / RECORD_ENTRY_SIZE;
+
+    // Constructor for BTRecordNode();
+    BTRecordNode();
+
+   /**
+    * Insert the (key, value) pair to the node, behind the entries
+    * with the same key.
+    * @param key[IN] the key to insert
+    * @param value[IN] the value to insert
+    * @return 0 if successful. Return an error code if the node is full.
+    */
+    RC insert(int key, const std::string& value);
+
+   /**
+    * Insert the (key, value) pair to the node
+    * and split the node with sibling: half and half, or 90/10 when the
+    * new entry goes before or behind all others.
+    * The first key of the sibling node is returned in siblingKey.
+    * @param key[IN] the key to insert.
+    * @param value[IN] the value to insert.
+    * @param sibling[IN] the sibling node to split with. This node MUST be EMPTY when this function is called.
+    * @param siblingKey[OUT] the first key in the sibling node after split.
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC insertAndSplit(int key, const std::string& value, BTRecordNode& sibling, int& siblingKey);
+
+   /**
+    * Set eid to the first entry whose key is not smaller than searchKey,
+    * or to the number of entries if there is no such entry.
+    * @param searchKey[IN] the key to search for.
+    * @param eid[OUT] the entry number of the first key >= searchKey.
+    * @return 0 if searchKey is found. If not, RC_NO_SUCH_RECORD.
+    */
+    RC locate(int searchKey, int& eid);
+
+   /**
+    * Read the (key, value) pair from the eid entry.
+    * @param eid[IN] the entry number to read
+    * @param key[OUT] the key from the entry
+    * @param value[OUT] the value from the entry
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC readEntry(int eid, int& key, std::string& value);
+
+   /**
+    * Change the value of the eid entry.
+    * @param eid[IN] the entry number to change
+    * @param value[IN] the new value of the entry
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC setValue(int eid, const std::string& value);
+
+   /**
+    * Remove the eid entry from the node, shifting the entries behind it.
+    * @param eid[IN] the entry number to remove
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC remove(int eid);
+
+   /**
+    * Return the pid of the next slibling node.
+    * @return the PageId of the next sibling node
+    */
+    PageId getNextNodePtr();
+
+   /**
+    * Set the next slibling node PageId.
+    * @param pid[IN] the PageId of the next sibling node
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC setNextNodePtr(PageId pid);
+
+   /**
+    * Return the number of keys stored in the node.
+    * @return the number of keys in the node
+    */
+    int getKeyCount();
+
+   /**
+    * Read the content of the node from the page pid in the PageFile pf.
+    * @param pid[IN] the PageId to read
+    * @param pf[IN] PageFile to read from
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC read(PageId pid, const PageFile& pf);
+
+   /**
+    * Write the content of the node to the page pid in the PageFile pf.
+    * @param pid[IN] the PageId to write to
+    * @param pf[IN] PageFile to write to
+    * @return 0 if successful. Return an error code if there is an error.
+    */
+    RC write(PageId pid, PageFile& pf);
+
+  private:
+    // set the number of keys stored in the node
+    void setKeyCount(int number);
+
+    // get a pointer to the keys of the node
+    int* getKeys();
+
+    // get a pointer to the value of the eid entry
+    char* getValue(int eid);
+
+   /**
+    * The main memory buffer for loading the content of the disk page
+    * that contains the node.
+    */
+    char buffer[PageFile::PAGE_SIZE];
+};
+
 #endif /* BTREENODE_H */
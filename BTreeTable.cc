@@ -0,0 +1,315 @@
+/**
+ * BTreeTable: an index-organized table.
+ *
+ * Page 0 of the file stores rootPid, treeHeight and tupleCount. The leaf
+ * nodes are BTRecordNodes and the non-leaf nodes are BTNonLeafNodes.
+ */
+
+#include "BTreeTable.h"
+#include "BTreeNode.h"
+#include <string.h>
+#include <limits.h>
+#include <stack>
+
+using namespace std;
+
+/*
+ * BTreeTable constructor
+ */
+BTreeTable::BTreeTable()
+{
+	rootPid = -1;
+	treeHeight = 0;
+	tupleCount = 0;
+	dirty = false;
+}
+
+/*
+ * Open the table file in read or write mode.
+ * Under 'w' mode, the file is created if it does not exist.
+ * @param filename[IN] the name of the table file
+ * @param mode[IN] 'r' for read, 'w' for write
+ * @return error code. 0 if no error
+ */
+RC BTreeTable::open(const string& filename, char mode)
+{
+	char buffer[PageFile::PAGE_SIZE];
+
+	RC errorMsg = pf.open(filename, mode);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	rootPid = -1;
+	treeHeight = 0;
+	tupleCount = 0;
+
+	// a new file gets its boot page at close(). we reserve the page here.
+	dirty = (pf.endPid() == 0);
+	if (dirty)
+	{
+		memset(buffer, 0, PageFile::PAGE_SIZE);
+		errorMsg = pf.write(BTREE_BOOT_UP_PID, buffer);
+		if (errorMsg != 0)
+			pf.close();
+		return errorMsg;
+	}
+
+	errorMsg = pf.read(BTREE_BOOT_UP_PID, buffer);
+	if (errorMsg != 0)
+	{
+		pf.close();
+		return errorMsg;
+	}
+	memcpy(&rootPid, buffer, sizeof(PageId));
+	memcpy(&treeHeight, buffer + sizeof(PageId), sizeof(int));
+	memcpy(&tupleCount, buffer + sizeof(PageId) + sizeof(int), sizeof(int));
+	return 0;
+}
+
+/*
+ * Close the table file.
+ * @return error code. 0 if no error
+ */
+RC BTreeTable::close()
+{
+	char buffer[PageFile::PAGE_SIZE];
+
+	if (dirty)
+	{
+		memset(buffer, 0, PageFile::PAGE_SIZE);
+		memcpy(buffer, &rootPid, sizeof(PageId));
+		memcpy(buffer + sizeof(PageId), &treeHeight, sizeof(int));
+		memcpy(buffer + sizeof(PageId) + sizeof(int), &tupleCount, sizeof(int));
+		RC errorMsg = pf.write(BTREE_BOOT_UP_PID, buffer);
+		if (errorMsg != 0)
+		{
+			pf.close();
+			return errorMsg;
+		}
+		dirty = false;
+	}
+	return pf.close();
+}
+
+/*
+ * Insert a tuple into the table.
+ * @param key[IN] the key of the tuple
+ * @param value[IN] the value of the tuple
+ * @return error code. 0 if no error
+ */
+RC BTreeTable::insert(int key, const string& value)
+{
+	RC errorMsg;
+
+	dirty = true;
+	if (treeHeight == 0)
+	{
+		BTRecordNode first;
+		first.insert(key, value);
+		rootPid = pf.endPid();
+		errorMsg = first.write(rootPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+		treeHeight++;
+		tupleCount++;
+		return 0;
+	}
+
+	BTNonLeafNode nonLeafNode;
+	PageId readPid = rootPid;
+	stack<PageId> pids;		// used to find parent pids in the event of splits
+	for (int height = treeHeight; height > 1; height--)
+	{
+		errorMsg = nonLeafNode.read(readPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		// save the parent pid in case of a node split
+		pids.push(readPid);
+
+		errorMsg = nonLeafNode.locateChildPtr(key, readPid);
+		if (errorMsg != 0)
+			return errorMsg;
+	}
+
+	// we have gotten to our leaf node
+	BTRecordNode leafNode;
+	errorMsg = leafNode.read(readPid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	if (leafNode.insert(key, value) != RC_NODE_FULL)
+	{
+		tupleCount++;
+		return leafNode.write(readPid, pf);
+	}
+
+	// split the leaf node with a new sibling behind it
+	BTRecordNode sibling;
+	int siblingKey;
+	PageId siblingPid = pf.endPid();
+
+	errorMsg = leafNode.insertAndSplit(key, value, sibling, siblingKey);
+	if (errorMsg != 0)
+		return errorMsg;
+	leafNode.setNextNodePtr(siblingPid);
+	if ((errorMsg = leafNode.write(readPid, pf)) != 0 ||
+	    (errorMsg = sibling.write(siblingPid, pf)) != 0)
+		return errorMsg;
+	tupleCount++;
+
+	// continually try to insert into parent non-leaf nodes and split if overflow
+	int newKey = siblingKey;
+	PageId newPid = siblingPid;
+	PageId splitPid = readPid;	// the node the new one was split from
+	while (!pids.empty())
+	{
+		BTNonLeafNode parent;
+		PageId parentPid = pids.top();
+		pids.pop();
+		errorMsg = parent.read(parentPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		if (parent.insert(newKey, newPid, splitPid) != RC_NODE_FULL)
+			return parent.write(parentPid, pf);
+
+		BTNonLeafNode nonLeafSibling;
+		int midKey;
+		errorMsg = parent.insertAndSplit(newKey, newPid, splitPid, nonLeafSibling, midKey);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		newPid = pf.endPid();
+		if ((errorMsg = parent.write(parentPid, pf)) != 0 ||
+		    (errorMsg = nonLeafSibling.write(newPid, pf)) != 0)
+			return errorMsg;
+		newKey = midKey;
+		splitPid = parentPid;
+	}
+
+	// if we got here, we've overflowed the root node as well
+	BTNonLeafNode newRoot;
+	errorMsg = newRoot.initializeRoot(rootPid, newKey, newPid);
+	if (errorMsg != 0)
+		return errorMsg;
+	rootPid = pf.endPid();
+	errorMsg = newRoot.write(rootPid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+	treeHeight++;
+	return 0;
+}
+
+/*
+ * Set the cursor to the first tuple whose key is not smaller than
+ * searchKey.
+ * @param searchKey[IN] the key to find
+ * @param cursor[OUT] the cursor pointing to the tuple
+ * @return 0 if searchKey is found. Othewise an error code
+ */
+RC BTreeTable::locate(int searchKey, IndexCursor& cursor)
+{
+	RC errorMsg;
+
+	// an empty tree has no leaf node. readForward() stops right away.
+	cursor.pid = 0;
+	cursor.eid = 0;
+	if (treeHeight == 0)
+		return RC_NO_SUCH_RECORD;
+
+	BTNonLeafNode nonLeafNode;
+	PageId readPid = rootPid;
+	for (int height = treeHeight; height > 1; height--)
+	{
+		errorMsg = nonLeafNode.read(readPid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		// go left on a separator equal to searchKey, as in BTree::locate()
+		errorMsg = nonLeafNode.locateLeftChildPtr(searchKey, readPid);
+		if (errorMsg != 0)
+			return errorMsg;
+	}
+
+	BTRecordNode leafNode;
+	errorMsg = leafNode.read(readPid, pf);
+	if (errorMsg != 0)
+		return errorMsg;
+
+	cursor.pid = readPid;
+	return leafNode.locate(searchKey, cursor.eid);
+}
+
+/*
+ * Read the tuple at the cursor and move the cursor forward.
+ * @param cursor[IN/OUT] the cursor pointing to a tuple
+ * @param key[OUT] the key of the tuple
+ * @param value[OUT] the value of the tuple
+ * @return error code. RC_END_OF_TREE at the end of the table
+ */
+RC BTreeTable::readForward(IndexCursor& cursor, int& key, string& value)
+{
+	BTRecordNode leafNode;
+
+	// move on to the next node at the end of a node. the cursor stays
+	// in the node of the tuple it has read, so that the tuple can be
+	// updated or removed.
+	while (true)
+	{
+		if (cursor.pid <= 0)
+			return RC_END_OF_TREE;
+
+		RC errorMsg = leafNode.read(cursor.pid, pf);
+		if (errorMsg != 0)
+			return errorMsg;
+
+		if (cursor.eid < leafNode.getKeyCount())
+			break;
+		cursor.pid = leafNode.getNextNodePtr();
+		cursor.eid = 0;
+	}
+
+	RC errorMsg = leafNode.readEntry(cursor.eid, key, value);
+	if (errorMsg != 0)
+		return errorMsg;
+	cursor.eid++;
+	return 0;
+}
+
+/*
+ * Change the value of the tuple at the cursor.
+ * @param cursor[IN] the cursor pointing to the tuple
+ * @param value[IN] the new value of the tuple
+ * @return error code. 0 if no error
+ */
+RC BTreeTable::update(const IndexCursor& cursor, const string& value)
+{
+	BTRecordNode leafNode;
+	RC errorMsg;
+
+	if ((errorMsg = leafNode.read(cursor.pid, pf)) != 0 ||
+	    (errorMsg = leafNode.setValue(cursor.eid, value)) != 0)
+		return errorMsg;
+	return leafNode.write(cursor.pid, pf);
+}
+
+/*
+ * Remove the tuple at the cursor.
+ * @param cursor[IN] the cursor pointing to the tuple
+ * @return error code. 0 if no error
+ */
+RC BTreeTable::remove(const IndexCursor& cursor)
+{
+	BTRecordNode leafNode;
+	RC errorMsg;
+
+	if ((errorMsg = leafNode.read(cursor.pid, pf)) != 0 ||
+	    (errorMsg = leafNode.remove(cursor.eid)) != 0)
+		return errorMsg;
+	if ((errorMsg = leafNode.write(cursor.pid, pf)) != 0)
+		return errorMsg;
+	tupleCount--;
+	dirty = true;
+	return 0;
+}
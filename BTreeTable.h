@@ -0,0 +1,101 @@
+/**
+ * BTreeTable: an index-organized table.
+ *
+ * The tuples of the table are stored in the leaf nodes of a B+tree sorted
+ * by key, so the tree is both the table and its index. A point lookup reads
+ * treeHeight pages, and a range scan reads the leaf nodes one after another.
+ * The non-leaf nodes are the same as in BTreeIndex.
+ */
+
+#ifndef BTREETABLE_H
+#define BTREETABLE_H
+
+#include <string>
+#include "Bruinbase.h"
+#include "PageFile.h"
+#include "BTreeIndex.h"
+
+class BTreeTable {
+ public:
+  BTreeTable();
+
+  // pid value where we store rootPid, treeHeight and tupleCount
+  static const int BTREE_BOOT_UP_PID = 0;
+
+  // the position of a scan: the leaf and the entry in it
+  typedef IndexCursor Cursor;
+
+  /**
+   * open the table file in read or write mode.
+   * under 'w' mode, the file is created if it does not exist.
+   * @param filename[IN] the name of the table file
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename, char mode);
+
+  /**
+   * close the table file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * insert a tuple into the table.
+   * @param key[IN] the key of the tuple
+   * @param value[IN] the value of the tuple
+   * @return error code. 0 if no error
+   */
+  RC insert(int key, const std::string& value);
+
+  /**
+   * set the cursor to the first tuple whose key is not smaller than
+   * searchKey. readForward() reads the tuples from there on.
+   * @param searchKey[IN] the key to find
+   * @param cursor[OUT] the cursor pointing to the tuple
+   * @return 0 if searchKey is found. Othewise an error code
+   */
+  RC locate(int searchKey, IndexCursor& cursor);
+
+  /**
+   * read the tuple at the cursor and move the cursor forward.
+   * afterwards, the tuple read is entry (cursor.eid - 1) of node cursor.pid.
+   * @param cursor[IN/OUT] the cursor pointing to a tuple
+   * @param key[OUT] the key of the tuple
+   * @param value[OUT] the value of the tuple
+   * @return error code. RC_END_OF_TREE at the end of the table
+   */
+  RC readForward(IndexCursor& cursor, int& key, std::string& value);
+
+  /**
+   * change the value of the tuple at the cursor.
+   * @param cursor[IN] the cursor pointing to the tuple
+   * @param value[IN] the new value of the tuple
+   * @return error code. 0 if no error
+   */
+  RC update(const IndexCursor& cursor, const std::string& value);
+
+  /**
+   * remove the tuple at the cursor. the tuples behind it in the same node
+   * move one entry forward. the node is not merged with its siblings even
+   * if it becomes empty; readForward() skips empty nodes.
+   * @param cursor[IN] the cursor pointing to the tuple
+   * @return error code. 0 if no error
+   */
+  RC remove(const IndexCursor& cursor);
+
+  /**
+   * @return the number of tuples in the table
+   */
+  int getTupleCount() const { return tupleCount; }
+
+ private:
+  PageFile pf;         /// the PageFile used to store the b+tree
+
+  PageId   rootPid;    /// the PageId of the root node
+  int      treeHeight; /// the height of the tree
+  int      tupleCount; /// the number of tuples in the table
+  bool     dirty;      /// true if the three values above have changed
+};
+
+#endif /* BTREETABLE_H */
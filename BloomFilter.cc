@@ -0,0 +1,271 @@
+/**
+ * BloomFilter: an optional sidecar file of Bloom filters over a table.
+ *
+ * Page 0 of the filter file is the header (capacity, # tuples, # table
+ * filter pages per column, # zones, zone filter size). Pages 1 .. blockCount
+ * hold the table filter of the key column and the next blockCount pages the
+ * one of the value column. The zone filters follow, zonesPerPage per page.
+ */
+
+#include "Bruinbase.h"
+#include "BloomFilter.h"
+#include "ZoneMap.h"
+#include <cstdio>
+#include <cstring>
+
+using std::string;
+
+static const int BLOCK_BITS = PageFile::PAGE_SIZE * 8;
+
+BloomFilter::BloomFilter()
+{
+  capacity = 0;
+  tupleCount = 0;
+  blockCount = 0;
+  zoneCount = 0;
+  zoneSize = ZONE_FILTER_SIZE;
+  zonesPerPage = PageFile::PAGE_SIZE / (2 * zoneSize);
+}
+
+RC BloomFilter::create(const string& filename, int capacity, int recordsPerPage)
+{
+  RC rc;
+
+  // start from an empty file
+  remove(filename.c_str());
+  if ((rc = pf.open(filename, 'w')) < 0) return rc;
+
+  if (capacity < 1) capacity = 1;
+  this->capacity = capacity;
+  tupleCount = 0;
+  zoneCount = 0;
+  blockCount = (int) (((long long) capacity * BITS_PER_TUPLE + BLOCK_BITS - 1) / BLOCK_BITS);
+
+  // a zone of a dictionary-coded table holds over ten times the tuples of a
+  // plain one. a fixed-size filter would have all its bits set there.
+  zoneSize = (recordsPerPage * ZoneMap::ZONE_PAGES * BITS_PER_TUPLE + 7) / 8;
+  if (zoneSize < ZONE_FILTER_SIZE) zoneSize = ZONE_FILTER_SIZE;
+  if (zoneSize > PageFile::PAGE_SIZE / 2) zoneSize = PageFile::PAGE_SIZE / 2;
+  zonesPerPage = PageFile::PAGE_SIZE / (2 * zoneSize);
+
+  // the header is written at close()
+  char* page;
+  return getPage(0, page);
+}
+
+RC BloomFilter::open(const string& filename, char mode)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if ((rc = pf.open(filename, mode)) < 0) return rc;
+
+  // opening in 'w' mode creates the file. an empty file is no filter.
+  if (pf.endPid() == 0) {
+    pf.close();
+    remove(filename.c_str());
+    return RC_FILE_OPEN_FAILED;
+  }
+
+  if ((rc = pf.read(0, page)) < 0) {
+    pf.close();
+    return RC_INVALID_FILE_FORMAT;
+  }
+  memcpy(&capacity, page, sizeof(int));
+  memcpy(&tupleCount, page + sizeof(int), sizeof(int));
+  memcpy(&blockCount, page + 2 * sizeof(int), sizeof(int));
+  memcpy(&zoneCount, page + 3 * sizeof(int), sizeof(int));
+  memcpy(&zoneSize, page + 4 * sizeof(int), sizeof(int));
+  if (zoneSize <= 0 || zoneSize > PageFile::PAGE_SIZE / 2) {
+    pf.close();
+    return RC_INVALID_FILE_FORMAT;
+  }
+  zonesPerPage = PageFile::PAGE_SIZE / (2 * zoneSize);
+
+  // the header is rewritten at close() when the filter is modified
+  if (mode == 'w' || mode == 'W') {
+    char* p;
+    return getPage(0, p);
+  }
+  return 0;
+}
+
+RC BloomFilter::close()
+{
+  RC rc;
+  std::map<PageId, std::vector<char> >::iterator it;
+
+  // page 0 is in the list of modified pages only in 'w' mode
+  it = dirty.find(0);
+  if (it != dirty.end()) {
+    char* page = &it->second[0];
+    memcpy(page, &capacity, sizeof(int));
+    memcpy(page + sizeof(int), &tupleCount, sizeof(int));
+    memcpy(page + 2 * sizeof(int), &blockCount, sizeof(int));
+    memcpy(page + 3 * sizeof(int), &zoneCount, sizeof(int));
+    memcpy(page + 4 * sizeof(int), &zoneSize, sizeof(int));
+  }
+
+  // write the modified pages in page order
+  for (it = dirty.begin(); it != dirty.end(); ++it) {
+    if ((rc = pf.write(it->first, &it->second[0])) < 0) {
+      dirty.clear();
+      pf.close();
+      return rc;
+    }
+  }
+  dirty.clear();
+
+  return pf.close();
+}
+
+RC BloomFilter::add(const RecordId& rid, int key, const string& value)
+{
+  RC    rc;
+  char* page;
+  int   zid = ZoneMap::zoneOf(rid);
+
+  // the table stores the value truncated to MAX_VALUE_LENGTH - 1 characters
+  string v = value.substr(0, RecordFile::MAX_VALUE_LENGTH - 1);
+  unsigned long long hk = hashKey(key);
+  unsigned long long hv = hashValue(v);
+
+  // table filters
+  if ((rc = getPage(blockOf(1, hk), page)) < 0) return rc;
+  setBits(page, BLOCK_BITS, hk);
+  if ((rc = getPage(blockOf(2, hv), page)) < 0) return rc;
+  setBits(page, BLOCK_BITS, hv);
+
+  // zone filters
+  if ((rc = getPage(zonePage(zid), page)) < 0) return rc;
+  setBits(page + zoneOffset(1, zid), zoneSize * 8, hk);
+  setBits(page + zoneOffset(2, zid), zoneSize * 8, hv);
+
+  if (zid >= zoneCount) zoneCount = zid + 1;
+  tupleCount++;
+
+  return 0;
+}
+
+bool BloomFilter::mayContainKey(int key) const
+{
+  unsigned long long h = hashKey(key);
+  return test(blockOf(1, h), 0, BLOCK_BITS, h);
+}
+
+bool BloomFilter::mayContainValue(const string& value) const
+{
+  unsigned long long h = hashValue(value);
+  return test(blockOf(2, h), 0, BLOCK_BITS, h);
+}
+
+bool BloomFilter::zoneMayContainKey(int zid, int key) const
+{
+  // we know nothing about the zones that have never been filled
+  if (zid < 0 || zid >= zoneCount) return true;
+  return test(zonePage(zid), zoneOffset(1, zid), zoneSize * 8, hashKey(key));
+}
+
+bool BloomFilter::zoneMayContainValue(int zid, const string& value) const
+{
+  if (zid < 0 || zid >= zoneCount) return true;
+  return test(zonePage(zid), zoneOffset(2, zid), zoneSize * 8, hashValue(value));
+}
+
+unsigned long long BloomFilter::hashKey(int key)
+{
+  // the finalizer of splitmix64
+  unsigned long long h = (unsigned int) key;
+  h += 0x9e3779b97f4a7c15ULL;
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return h ^ (h >> 31);
+}
+
+unsigned long long BloomFilter::hashValue(const string& value)
+{
+  // FNV-1a, mixed by the key hash to spread the low bits
+  unsigned long long h = 0xcbf29ce484222325ULL;
+  for (unsigned i = 0; i < value.size(); i++) {
+    h ^= (unsigned char) value[i];
+    h *= 0x100000001b3ULL;
+  }
+  return hashKey((int) h) ^ (h >> 32);
+}
+
+void BloomFilter::setBits(char* filter, int nbits, unsigned long long h)
+{
+  // double hashing: the i-th bit is h1 + i * h2
+  unsigned int h1 = (unsigned int) h;
+  unsigned int h2 = (unsigned int) (h >> 32) | 1;
+  for (int i = 0; i < HASH_COUNT; i++) {
+    unsigned int bit = (h1 + i * h2) % nbits;
+    filter[bit >> 3] |= (char) (1 << (bit & 7));
+  }
+}
+
+bool BloomFilter::testBits(const char* filter, int nbits, unsigned long long h)
+{
+  unsigned int h1 = (unsigned int) h;
+  unsigned int h2 = (unsigned int) (h >> 32) | 1;
+  for (int i = 0; i < HASH_COUNT; i++) {
+    unsigned int bit = (h1 + i * h2) % nbits;
+    if ((filter[bit >> 3] & (1 << (bit & 7))) == 0) return false;
+  }
+  return true;
+}
+
+PageId BloomFilter::blockOf(int attr, unsigned long long h) const
+{
+  // pick the block with bits of the hash not used by setBits()
+  unsigned int b = (unsigned int) ((h >> 17) ^ (h >> 49)) % blockCount;
+  return 1 + (attr - 1) * blockCount + b;
+}
+
+int BloomFilter::zoneOffset(int attr, int zid) const
+{
+  return (zid % zonesPerPage) * 2 * zoneSize + (attr - 1) * zoneSize;
+}
+
+PageId BloomFilter::zonePage(int zid) const
+{
+  return 1 + 2 * blockCount + zid / zonesPerPage;
+}
+
+bool BloomFilter::test(PageId pid, int offset, int nbits, unsigned long long h) const
+{
+  char page[PageFile::PAGE_SIZE];
+
+  std::map<PageId, std::vector<char> >::const_iterator it = dirty.find(pid);
+  if (it != dirty.end()) {
+    return testBits(&it->second[0] + offset, nbits, h);
+  }
+
+  // a page that has never been written has no bit set
+  if (pid >= pf.endPid()) return false;
+
+  // on a read error we cannot rule anything out
+  if (pf.read(pid, page) < 0) return true;
+
+  return testBits(page + offset, nbits, h);
+}
+
+RC BloomFilter::getPage(PageId pid, char*& page)
+{
+  RC rc;
+  std::map<PageId, std::vector<char> >::iterator it = dirty.find(pid);
+
+  if (it == dirty.end()) {
+    std::vector<char>& buf = dirty[pid];
+    buf.assign(PageFile::PAGE_SIZE, 0);
+    if (pid < pf.endPid() && (rc = pf.read(pid, &buf[0])) < 0) {
+      dirty.erase(pid);
+      return rc;
+    }
+    page = &buf[0];
+  } else {
+    page = &it->second[0];
+  }
+
+  return 0;
+}
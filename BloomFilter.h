@@ -0,0 +1,139 @@
+/**
+ * BloomFilter: an optional sidecar file that answers "is there a tuple with
+ * this key (or value) in the table?" with either "definitely not" or "maybe".
+ *
+ * The file keeps one filter for the whole table and one small filter for
+ * every zone of the table (see ZoneMap), for both the key and the value
+ * column. The table filter is blocked: a lookup only touches the one page
+ * selected by the hash, so a negative point lookup costs one page read.
+ */
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "PageFile.h"
+#include "RecordFile.h"
+
+class BloomFilter {
+ public:
+
+  // bits of the table filter reserved for each tuple
+  static const int BITS_PER_TUPLE = 10;
+
+  // number of bits set for each key or value
+  static const int HASH_COUNT = 7;
+
+  // minimum bytes of the key (and of the value) filter of one zone.
+  // the zone filters of a table with many records per page are larger,
+  // up to half a page, so that they keep about BITS_PER_TUPLE bits a tuple.
+  static const int ZONE_FILTER_SIZE = 64;
+
+  BloomFilter();
+
+  /**
+   * create a new, empty filter file sized for capacity tuples.
+   * an existing file with the same name is overwritten.
+   * the filter is open in 'w' mode afterwards.
+   * @param filename[IN] the name of the filter file
+   * @param capacity[IN] the number of tuples the filter is sized for
+   * @param recordsPerPage[IN] the number of tuples in a page of the table
+   * @return error code. 0 if no error
+   */
+  RC create(const std::string& filename, int capacity, int recordsPerPage);
+
+  /**
+   * open an existing filter file in read or write mode.
+   * @param filename[IN] the name of the filter file
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename, char mode);
+
+  /**
+   * write the modified pages to the disk and close the file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * add a tuple to the table filter and to the filter of its zone.
+   * @param rid[IN] the location of the tuple in the table
+   * @param key[IN] the key of the tuple
+   * @param value[IN] the value of the tuple
+   * @return error code. 0 if no error
+   */
+  RC add(const RecordId& rid, int key, const std::string& value);
+
+  /**
+   * @param key[IN] the key to look for
+   * @return false if no tuple of the table has the key
+   */
+  bool mayContainKey(int key) const;
+
+  /**
+   * @param value[IN] the value to look for
+   * @return false if no tuple of the table has the value
+   */
+  bool mayContainValue(const std::string& value) const;
+
+  /**
+   * @param zid[IN] the zone to check
+   * @param key[IN] the key to look for
+   * @return false if no tuple of the zone has the key
+   */
+  bool zoneMayContainKey(int zid, int key) const;
+
+  /**
+   * @param zid[IN] the zone to check
+   * @param value[IN] the value to look for
+   * @return false if no tuple of the zone has the value
+   */
+  bool zoneMayContainValue(int zid, const std::string& value) const;
+
+  /**
+   * @return the number of tuples the filter was sized for
+   */
+  int getCapacity() const { return capacity; }
+
+  /**
+   * @return the number of tuples added to the filter
+   */
+  int getTupleCount() const { return tupleCount; }
+
+ private:
+  // hash a key or a value
+  static unsigned long long hashKey(int key);
+  static unsigned long long hashValue(const std::string& value);
+
+  // set or test the HASH_COUNT bits of hash h in the nbits-bit filter
+  static void setBits(char* filter, int nbits, unsigned long long h);
+  static bool testBits(const char* filter, int nbits, unsigned long long h);
+
+  // the table filter page of hash h. attr: 1 - key, 2 - value
+  PageId blockOf(int attr, unsigned long long h) const;
+
+  // the byte offset of a zone filter inside its page. attr: 1 - key, 2 - value
+  int zoneOffset(int attr, int zid) const;
+  PageId zonePage(int zid) const;
+
+  bool test(PageId pid, int offset, int nbits, unsigned long long h) const;
+
+  // get a page for modification. the page is written back at close()
+  RC getPage(PageId pid, char*& page);
+
+  PageFile pf;          // the PageFile used to store the filter
+  int      capacity;    // the number of tuples the filter was sized for
+  int      tupleCount;  // the number of tuples added to the filter
+  int      blockCount;  // the number of table filter pages per column
+  int      zoneCount;   // the number of zone filters in the file
+  int      zoneSize;    // the bytes of the key (or value) filter of a zone
+  int      zonesPerPage;  // the number of zone filters stored in one page
+
+  std::map<PageId, std::vector<char> > dirty;  // pages modified in 'w' mode
+};
+
+#endif // BLOOMFILTER_H
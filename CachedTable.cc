@@ -0,0 +1,62 @@
+/**
+ * CachedTable: an in-memory copy of a table.
+ */
+
+#include <algorithm>
+#include "Bruinbase.h"
+#include "CachedTable.h"
+
+using std::string;
+using std::vector;
+using std::pair;
+
+CachedTable::CachedTable()
+{
+  offsets.push_back(0);
+}
+
+void CachedTable::build(const vector<pair<int, string> >& tuples)
+{
+  unsigned size = 0;
+
+  for (unsigned i = 0; i < tuples.size(); i++)
+    size += tuples[i].second.size();
+
+  keys.clear();
+  offsets.clear();
+  arena.clear();
+  keys.reserve(tuples.size());
+  offsets.reserve(tuples.size() + 1);
+  arena.reserve(size);
+
+  offsets.push_back(0);
+  for (unsigned i = 0; i < tuples.size(); i++) {
+    keys.push_back(tuples[i].first);
+    arena.append(tuples[i].second);
+    offsets.push_back(arena.size());
+  }
+}
+
+RC CachedTable::locate(int searchKey, IndexCursor& cursor) const
+{
+  cursor.pid = 0;
+  cursor.eid = std::lower_bound(keys.begin(), keys.end(), searchKey) - keys.begin();
+
+  return 0;
+}
+
+RC CachedTable::readForward(IndexCursor& cursor, int& key, string& value) const
+{
+  if (cursor.eid < 0 || cursor.eid >= (int) keys.size()) return RC_END_OF_TREE;
+
+  key = keys[cursor.eid];
+  value.assign(arena, offsets[cursor.eid], offsets[cursor.eid + 1] - offsets[cursor.eid]);
+  cursor.eid++;
+
+  return 0;
+}
+
+int CachedTable::getTupleCount() const
+{
+  return keys.size();
+}
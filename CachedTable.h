@@ -0,0 +1,61 @@
+/**
+ * CachedTable: an in-memory copy of a table, built by CACHE TABLE.
+ *
+ * The tuples are kept in two columns: a sorted array of the keys and an
+ * arena with the values one after another. offsets[i] is where the value
+ * of tuple i starts in the arena, and offsets[i + 1] where it ends. A
+ * lookup is a binary search in the key array, so a cached table is read
+ * without any page I/O.
+ */
+
+#ifndef CACHEDTABLE_H
+#define CACHEDTABLE_H
+
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "BTreeIndex.h"
+
+class CachedTable {
+ public:
+
+  // the position of a scan: the tuple in the cache
+  typedef IndexCursor Cursor;
+
+  CachedTable();
+
+  /**
+   * replace the tuples of the cache.
+   * @param tuples[IN] the tuples of the table, sorted by key
+   */
+  void build(const std::vector<std::pair<int, std::string> >& tuples);
+
+  /**
+   * find the first tuple with a key >= searchKey.
+   * @param searchKey[IN] the key to look for
+   * @param cursor[OUT] the position of the tuple
+   * @return error code. 0 if no error
+   */
+  RC locate(int searchKey, IndexCursor& cursor) const;
+
+  /**
+   * read the tuple at the cursor and move the cursor to the next tuple.
+   * @param cursor[IN/OUT] the position of the tuple to read
+   * @param key[OUT] the key of the tuple
+   * @param value[OUT] the value of the tuple
+   * @return error code. RC_END_OF_TREE at the end of the table
+   */
+  RC readForward(IndexCursor& cursor, int& key, std::string& value) const;
+
+  /**
+   * @return the number of tuples in the cache
+   */
+  int getTupleCount() const;
+
+ private:
+  std::vector<int> keys;     // the keys of the tuples in order
+  std::vector<int> offsets;  // where the value of each tuple starts in arena
+  std::string      arena;    // the values of the tuples
+};
+
+#endif // CACHEDTABLE_H
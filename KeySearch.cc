@@ -0,0 +1,167 @@
+/**
+ * KeySearch: the kernels that search the sorted keys of a B+tree node.
+ */
+
+#include "KeySearch.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KEYSEARCH_X86
+#include <immintrin.h>
+#endif
+
+// a kernel counts the keys of a window of at most WINDOW keys that are
+// smaller than searchKey (orEqual == false) or not larger (orEqual == true)
+typedef int (*Kernel)(const int* keys, int count, int stride, int searchKey, bool orEqual);
+
+static int scalarKernel(const int* keys, int count, int stride, int searchKey, bool orEqual)
+{
+  int n = 0;
+
+  // the comparisons are summed, not branched on
+  for (int i = 0; i < count; i++)
+    n += orEqual ? (keys[i * stride] <= searchKey) : (keys[i * stride] < searchKey);
+
+  return n;
+}
+
+#ifdef KEYSEARCH_X86
+
+__attribute__((target("sse2")))
+static int sse2Kernel(const int* keys, int count, int stride, int searchKey, bool orEqual)
+{
+  __m128i key = _mm_set1_epi32(searchKey);
+  int     n = 0;
+
+  for (int i = 0; i < count; i += 4) {
+    int lanes = count - i < 4 ? count - i : 4;
+    int valid = (1 << lanes) - 1;
+
+    // SSE2 has no gather, so the keys are collected first
+    int window[4] = { 0, 0, 0, 0 };
+    for (int j = 0; j < lanes; j++)
+      window[j] = keys[(i + j) * stride];
+    __m128i v = _mm_loadu_si128((const __m128i*) window);
+
+    // lanes with a key smaller than searchKey, or larger for orEqual
+    __m128i hit = orEqual ? _mm_cmpgt_epi32(v, key) : _mm_cmplt_epi32(v, key);
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(hit)) & valid;
+    n += orEqual ? lanes - __builtin_popcount(mask) : __builtin_popcount(mask);
+  }
+
+  return n;
+}
+
+__attribute__((target("avx2")))
+static int avx2Kernel(const int* keys, int count, int stride, int searchKey, bool orEqual)
+{
+  __m256i key = _mm256_set1_epi32(searchKey);
+  __m256i index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+  int     n = 0;
+
+  for (int i = 0; i < count; i += 8) {
+    int lanes = count - i < 8 ? count - i : 8;
+    int valid = (1 << lanes) - 1;
+
+    // only the lanes of the keys are loaded, so we never read past the node
+    __m256i laneMask = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i v = (stride == 1) ? _mm256_maskload_epi32(keys + i, laneMask)
+                              : _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), keys + i * stride, index, laneMask, 4);
+
+    // lanes with a key smaller than searchKey, or larger for orEqual
+    __m256i hit = orEqual ? _mm256_cmpgt_epi32(v, key) : _mm256_cmpgt_epi32(key, v);
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(hit)) & valid;
+    n += orEqual ? lanes - __builtin_popcount(mask) : __builtin_popcount(mask);
+  }
+
+  return n;
+}
+
+#endif
+
+// choose the fastest kernel the CPU can run
+static Kernel chooseKernel(const char*& name)
+{
+#ifdef KEYSEARCH_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    name = "avx2";
+    return avx2Kernel;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    name = "sse2";
+    return sse2Kernel;
+  }
+#endif
+  name = "scalar";
+  return scalarKernel;
+}
+
+static const char* kernelName;
+static const Kernel kernel = chooseKernel(kernelName);
+
+// narrow the keys down to a window with a branch-free binary search,
+// then let the kernel count the keys of the window
+static int search(const int* keys, int count, int stride, int searchKey, bool orEqual)
+{
+  const int* base = keys;
+
+  while (count > KeySearch::WINDOW) {
+    int half = count / 2;
+    int k = base[(half - 1) * stride];
+    base = (orEqual ? k <= searchKey : k < searchKey) ? base + half * stride : base;
+    count -= half;
+  }
+
+  return (base - keys) / stride + kernel(base, count, stride, searchKey, orEqual);
+}
+
+// read the i-th number of a packed array of numbers of the given width
+static inline unsigned packedAt(const char* field, int width, int i)
+{
+  if (width == 1)
+    return ((const unsigned char*) field)[i];
+  if (width == 2) {
+    unsigned short value;
+    memcpy(&value, field + 2 * i, 2);
+    return value;
+  }
+  unsigned value;
+  memcpy(&value, field + 4 * i, 4);
+  return value;
+}
+
+int KeySearch::countPackedLess(const char* field, int width, int count, unsigned target)
+{
+  int base = 0;
+
+  // the same branch-free binary search as search(), on the packed numbers
+  while (count > WINDOW) {
+    int half = count / 2;
+    base = (packedAt(field, width, base + half - 1) < target) ? base + half : base;
+    count -= half;
+  }
+
+  // the kernels compare signed ints. flipping the sign bit of both
+  // sides keeps the order of the unsigned numbers.
+  int window[WINDOW];
+  for (int i = 0; i < count; i++)
+    window[i] = (int) (packedAt(field, width, base + i) ^ 0x80000000u);
+
+  return base + kernel(window, count, 1, (int) (target ^ 0x80000000u), false);
+}
+
+int KeySearch::countLess(const int* keys, int count, int stride, int searchKey)
+{
+  return search(keys, count, stride, searchKey, false);
+}
+
+int KeySearch::countNotGreater(const int* keys, int count, int stride, int searchKey)
+{
+  return search(keys, count, stride, searchKey, true);
+}
+
+const char* KeySearch::getKernelName()
+{
+  return kernelName;
+}
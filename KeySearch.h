@@ -0,0 +1,65 @@
+/**
+ * KeySearch: the kernels that search the sorted keys of a B+tree node.
+ *
+ * A search counts the keys of a node that are smaller than (or not larger
+ * than) a search key; for sorted keys the count is the position of the
+ * search key in the node. The keys are stored every stride ints, so the
+ * kernels work on the entries of any node format. A branch-free binary
+ * search narrows the keys down to a window of WINDOW keys, which are then
+ * compared with the search key all at once with SIMD instructions.
+ *
+ * The compressed keys of a leaf are searched the same way: the binary
+ * search reads the packed key offsets in place, and the window is widened
+ * to ints for the kernel.
+ *
+ * The kernel is chosen once at startup: AVX2 if the CPU has it, SSE2 on
+ * any other x86 CPU, and the plain binary search elsewhere.
+ */
+
+#ifndef KEYSEARCH_H
+#define KEYSEARCH_H
+
+class KeySearch {
+ public:
+
+  // the number of keys compared at once at the end of a search
+  static const int WINDOW = 16;
+
+  /**
+   * count the keys smaller than searchKey.
+   * @param keys[IN] the first key
+   * @param count[IN] the number of keys
+   * @param stride[IN] the distance between two keys, in ints
+   * @param searchKey[IN] the key to search for
+   * @return the number of keys smaller than searchKey
+   */
+  static int countLess(const int* keys, int count, int stride, int searchKey);
+
+  /**
+   * count the keys not larger than searchKey.
+   * @param keys[IN] the first key
+   * @param count[IN] the number of keys
+   * @param stride[IN] the distance between two keys, in ints
+   * @param searchKey[IN] the key to search for
+   * @return the number of keys smaller than or equal to searchKey
+   */
+  static int countNotGreater(const int* keys, int count, int stride, int searchKey);
+
+  /**
+   * count the numbers of a sorted array of packed unsigned numbers
+   * that are smaller than target.
+   * @param field[IN] the first number
+   * @param width[IN] the bytes of each number: 1, 2 or 4
+   * @param count[IN] the number of numbers
+   * @param target[IN] the number to search for
+   * @return the number of numbers smaller than target
+   */
+  static int countPackedLess(const char* field, int width, int count, unsigned target);
+
+  /**
+   * @return the name of the kernel in use: "avx2", "sse2" or "scalar"
+   */
+  static const char* getKernelName();
+};
+
+#endif // KEYSEARCH_H
@@ -0,0 +1,291 @@
+/**
+ * LSMTable: a log-structured table for write-heavy ingest.
+ *
+ * The manifest file has a single page: the number of runs, the id of the
+ * next run and the ids of the runs, from the oldest to the newest.
+ */
+
+#include "Bruinbase.h"
+#include "LSMTable.h"
+#include <cstdio>
+#include <cstring>
+#include <climits>
+
+using std::string;
+using std::vector;
+using std::pair;
+
+LSMTable::LSMTable()
+{
+  mode = 'r';
+  nextId = 0;
+}
+
+LSMTable::~LSMTable()
+{
+  closeRuns();
+}
+
+string LSMTable::runFile(int id) const
+{
+  char suffix[32];
+  sprintf(suffix, ".run%d", id);
+  return table + suffix;
+}
+
+RC LSMTable::open(const string& table, char mode)
+{
+  RC       rc;
+  PageFile pf;
+  char     page[PageFile::PAGE_SIZE];
+  int      count;
+
+  if ((rc = pf.open(table + ".lsm", mode)) < 0) return rc;
+
+  this->table = table;
+  this->mode = mode;
+  closeRuns();
+  runIds.clear();
+  memtable.clear();
+  nextId = 0;
+
+  // a new table has no runs. the manifest is written at close().
+  if (pf.endPid() > 0) {
+    if ((rc = pf.read(0, page)) < 0) {
+      pf.close();
+      return rc;
+    }
+    memcpy(&count, page, sizeof(int));
+    memcpy(&nextId, page + sizeof(int), sizeof(int));
+    runIds.resize(count);
+    memcpy(&runIds[0], page + 2 * sizeof(int), count * sizeof(int));
+  }
+  pf.close();
+
+  for (unsigned i = 0; i < runIds.size(); i++) {
+    SSTable* run = new SSTable;
+    if ((rc = run->open(runFile(runIds[i]))) < 0) {
+      delete run;
+      closeRuns();
+      return rc;
+    }
+    runs.push_back(run);
+  }
+
+  return 0;
+}
+
+RC LSMTable::close()
+{
+  RC rc = 0;
+
+  if (mode == 'w' || mode == 'W') {
+    if ((rc = flush()) == 0 && runs.size() > (unsigned) MAX_RUNS)
+      rc = compact();
+    if (rc == 0)
+      rc = writeManifest();
+  }
+  closeRuns();
+
+  return rc;
+}
+
+RC LSMTable::drop()
+{
+  closeRuns();
+  for (unsigned i = 0; i < runIds.size(); i++)
+    remove(runFile(runIds[i]).c_str());
+  runIds.clear();
+  memtable.clear();
+  mode = 'r';
+
+  return remove((table + ".lsm").c_str()) == 0 ? 0 : RC_FILE_WRITE_FAILED;
+}
+
+void LSMTable::closeRuns()
+{
+  for (unsigned i = 0; i < runs.size(); i++) {
+    runs[i]->close();
+    delete runs[i];
+  }
+  runs.clear();
+}
+
+RC LSMTable::writeManifest()
+{
+  RC       rc;
+  PageFile pf;
+  char     page[PageFile::PAGE_SIZE];
+  int      count = runIds.size();
+
+  if (2 * sizeof(int) + count * sizeof(int) > (unsigned) PageFile::PAGE_SIZE)
+    return RC_INVALID_FILE_FORMAT;
+
+  memset(page, 0, PageFile::PAGE_SIZE);
+  memcpy(page, &count, sizeof(int));
+  memcpy(page + sizeof(int), &nextId, sizeof(int));
+  if (count > 0)
+    memcpy(page + 2 * sizeof(int), &runIds[0], count * sizeof(int));
+
+  if ((rc = pf.open(table + ".lsm", 'w')) < 0) return rc;
+  if ((rc = pf.write(0, page)) < 0) {
+    pf.close();
+    return rc;
+  }
+  return pf.close();
+}
+
+RC LSMTable::insert(int key, const string& value)
+{
+  if (mode != 'w' && mode != 'W') return RC_INVALID_FILE_MODE;
+
+  // equal keys are kept in the order they are inserted
+  memtable.insert(std::make_pair(key, value));
+  if ((int) memtable.size() >= MEMTABLE_SIZE)
+    return flush();
+
+  return 0;
+}
+
+RC LSMTable::flush()
+{
+  RC       rc;
+  SSTable* run;
+  int      id;
+
+  if (memtable.empty()) return 0;
+
+  // the memtable is sorted, so the run is written sequentially
+  id = nextId++;
+  run = new SSTable;
+  if ((rc = run->create(runFile(id))) < 0) {
+    delete run;
+    return rc;
+  }
+  for (std::multimap<int, string>::const_iterator it = memtable.begin(); it != memtable.end(); ++it) {
+    if ((rc = run->append(it->first, it->second)) < 0) break;
+  }
+  if (rc < 0 || (rc = run->close()) < 0 || (rc = run->open(runFile(id))) < 0) {
+    run->close();
+    delete run;
+    remove(runFile(id).c_str());
+    return rc;
+  }
+  memtable.clear();
+
+  runIds.push_back(id);
+  runs.push_back(run);
+
+  return writeManifest();
+}
+
+RC LSMTable::compact()
+{
+  RC     rc;
+  Cursor cursor;
+  int    key;
+  string value;
+  vector<pair<int, string> > tuples;
+
+  if (runs.size() <= 1) return 0;
+
+  // merge the runs into a new one. the merged tuples are kept in
+  // memory until the old runs are gone.
+  if ((rc = locate(INT_MIN, INT_MAX, cursor)) < 0) return rc;
+  while ((rc = readForward(cursor, key, value)) == 0)
+    tuples.push_back(std::make_pair(key, value));
+  if (rc != RC_END_OF_TREE) return rc;
+
+  return rewrite(tuples);
+}
+
+RC LSMTable::rewrite(const vector<pair<int, string> >& tuples)
+{
+  RC       rc = 0;
+  SSTable* run;
+  int      id = nextId++;
+
+  // write the new run first, so the table stays readable on an error
+  run = new SSTable;
+  if ((rc = run->create(runFile(id))) < 0) {
+    delete run;
+    return rc;
+  }
+  for (unsigned i = 0; i < tuples.size(); i++) {
+    if ((rc = run->append(tuples[i].first, tuples[i].second)) < 0) break;
+  }
+  if (rc < 0 || (rc = run->close()) < 0 || (rc = run->open(runFile(id))) < 0) {
+    run->close();
+    delete run;
+    remove(runFile(id).c_str());
+    return rc;
+  }
+
+  // replace the old runs in the manifest, then drop their files
+  vector<int> oldIds = runIds;
+  closeRuns();
+  memtable.clear();
+  runIds.assign(1, id);
+  runs.push_back(run);
+  if ((rc = writeManifest()) < 0) return rc;
+  for (unsigned i = 0; i < oldIds.size(); i++)
+    remove(runFile(oldIds[i]).c_str());
+
+  return 0;
+}
+
+RC LSMTable::locate(int lo, int hi, Cursor& cursor)
+{
+  RC rc;
+
+  cursor.hi = hi;
+  cursor.positions.resize(runs.size());
+  cursor.hasNext.assign(runs.size(), false);
+  cursor.nextKeys.resize(runs.size());
+  cursor.nextValues.resize(runs.size());
+
+  for (unsigned i = 0; i < runs.size(); i++) {
+    // the fence pointers and the Bloom filter rule out most runs
+    if (!runs[i]->mayOverlap(lo, hi)) continue;
+    if (lo == hi && !runs[i]->mayContain(lo)) continue;
+
+    runs[i]->locate(lo, cursor.positions[i]);
+    rc = runs[i]->readForward(cursor.positions[i], cursor.nextKeys[i], cursor.nextValues[i]);
+    if (rc < 0 && rc != RC_END_OF_TREE) return rc;
+    cursor.hasNext[i] = (rc == 0 && cursor.nextKeys[i] <= hi);
+  }
+
+  return 0;
+}
+
+RC LSMTable::readForward(Cursor& cursor, int& key, string& value)
+{
+  RC  rc;
+  int run = -1;
+
+  // take the smallest key. on a tie, the older run comes first.
+  for (unsigned i = 0; i < cursor.hasNext.size(); i++) {
+    if (cursor.hasNext[i] && (run < 0 || cursor.nextKeys[i] < cursor.nextKeys[run]))
+      run = i;
+  }
+  if (run < 0) return RC_END_OF_TREE;
+
+  key = cursor.nextKeys[run];
+  value = cursor.nextValues[run];
+
+  rc = runs[run]->readForward(cursor.positions[run], cursor.nextKeys[run], cursor.nextValues[run]);
+  if (rc < 0 && rc != RC_END_OF_TREE) return rc;
+  cursor.hasNext[run] = (rc == 0 && cursor.nextKeys[run] <= cursor.hi);
+
+  return 0;
+}
+
+int LSMTable::getTupleCount() const
+{
+  int count = 0;
+
+  for (unsigned i = 0; i < runs.size(); i++)
+    count += runs[i]->getTupleCount();
+
+  return count;
+}
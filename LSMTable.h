@@ -0,0 +1,139 @@
+/**
+ * LSMTable: a log-structured table for write-heavy ingest.
+ *
+ * New tuples go to an in-memory memtable sorted by key. When the memtable
+ * is full, and when the table is closed, it is written out sequentially as
+ * an immutable sorted run (an SSTable). Reads merge the runs; the block
+ * index of each run (its fence pointers) skips the runs and blocks outside
+ * the key range, and the Bloom filter of each run skips the runs without
+ * the key of a point lookup. When there are more than MAX_RUNS runs, they
+ * are merged into one.
+ *
+ * The manifest file (.lsm) lists the runs of the table from the oldest to
+ * the newest. Each run is stored in a file named <table>.run<id>.
+ */
+
+#ifndef LSMTABLE_H
+#define LSMTABLE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "BTreeIndex.h"
+#include "SSTable.h"
+
+class LSMTable {
+ public:
+
+  // number of tuples the memtable holds before it is written as a run
+  static const int MEMTABLE_SIZE = 4096;
+
+  // number of runs above which the runs are merged into one
+  static const int MAX_RUNS = 4;
+
+  /**
+   * the position of a scan: the position in each run and the next tuple
+   * of each run, if it has one. a cursor stays valid until the runs of
+   * the table change.
+   */
+  struct Cursor {
+    int                      hi;         // the largest key to read
+    std::vector<IndexCursor> positions;  // the position in each run
+    std::vector<bool>        hasNext;    // true if the run has a next tuple
+    std::vector<int>         nextKeys;   // the key of the next tuple of each run
+    std::vector<std::string> nextValues; // the value of the next tuple of each run
+  };
+
+  LSMTable();
+  ~LSMTable();
+
+  /**
+   * open a table in read or write mode and open all of its runs.
+   * under 'w' mode, the table is created if it does not exist.
+   * @param table[IN] the table name
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& table, char mode);
+
+  /**
+   * write the memtable as a new run, merge the runs if there are
+   * too many of them, and close the table.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * remove the manifest and all runs of the table, and close it.
+   * @return error code. 0 if no error
+   */
+  RC drop();
+
+  /**
+   * add a tuple to the memtable.
+   * @param key[IN] the key of the tuple
+   * @param value[IN] the value of the tuple
+   * @return error code. 0 if no error
+   */
+  RC insert(int key, const std::string& value);
+
+  /**
+   * merge all runs into one.
+   * @return error code. 0 if no error
+   */
+  RC compact();
+
+  /**
+   * replace all tuples of the table with the given ones.
+   * @param tuples[IN] the new tuples of the table, sorted by key
+   * @return error code. 0 if no error
+   */
+  RC rewrite(const std::vector<std::pair<int, std::string> >& tuples);
+
+  /**
+   * start reading the tuples with keys in [lo, hi] in key order. tuples
+   * with the same key come in the order they were inserted.
+   * @param lo[IN] the smallest key to read
+   * @param hi[IN] the largest key to read
+   * @param cursor[OUT] the position of the scan
+   * @return error code. 0 if no error
+   */
+  RC locate(int lo, int hi, Cursor& cursor);
+
+  /**
+   * read the next tuple of the scan started by locate().
+   * @param cursor[IN/OUT] the position of the scan
+   * @param key[OUT] the key of the tuple
+   * @param value[OUT] the value of the tuple
+   * @return error code. RC_END_OF_TREE at the end of the table
+   */
+  RC readForward(Cursor& cursor, int& key, std::string& value);
+
+  /**
+   * @return the number of tuples in the runs of the table
+   */
+  int getTupleCount() const;
+
+ private:
+  // write the memtable as a new run
+  RC flush();
+
+  // write the list of runs to the manifest
+  RC writeManifest();
+
+  // close and forget all runs
+  void closeRuns();
+
+  // the name of the file of a run
+  std::string runFile(int id) const;
+
+  std::string table;   // the table name
+  char        mode;    // the mode the table was opened in
+  int         nextId;  // the id of the next run
+  std::vector<int>      runIds;  // the ids of the runs, from the oldest
+  std::vector<SSTable*> runs;    // the open runs, in the same order
+  std::multimap<int, std::string> memtable;  // the tuples not yet in a run
+};
+
+#endif // LSMTABLE_H
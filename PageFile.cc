@@ -72,8 +72,11 @@ RC PageFile::close()
 {
   if (fd <= 0) return RC_FILE_CLOSE_FAILED;
 
+  // write the modified pages before closing the file
+  RC rc = flush();
+
   // close the file
-  if (::close(fd) < 0) return RC_FILE_CLOSE_FAILED;
+  if (::close(fd) < 0) rc = RC_FILE_CLOSE_FAILED;
 
   // evict all cached pages for this file
   for (int i = 0; i < CACHE_COUNT; i++) {
@@ -81,12 +84,26 @@ RC PageFile::close()
        readCache[i].fd = 0;
        readCache[i].pid = 0;
        readCache[i].lastAccessed = 0;
+       readCache[i].dirty = false;
     }
   }
 
   // set the fd and epid to the initial state
   fd = -1; 
   epid = 0;
+  return rc;
+}
+
+RC PageFile::flush()
+{
+  RC rc;
+
+  for (int i = 0; i < CACHE_COUNT; i++) {
+    if (readCache[i].fd == fd && readCache[i].lastAccessed != 0) {
+      if ((rc = writeSlot(i)) < 0) return rc;
+    }
+  }
+
   return 0;
 }
 
@@ -95,39 +112,103 @@ PageId PageFile::endPid() const
   return epid;
 }
 
+RC PageFile::truncate(PageId pid)
+{
+  if (pid < 0 || pid > epid) return RC_INVALID_PID;
+
+  // cut the file at the beginning of page pid
+  if (::ftruncate(fd, (off_t) pid * PAGE_SIZE) < 0) return RC_FILE_WRITE_FAILED;
+
+  // evict the discarded pages from the cache without writing them
+  for (int i = 0; i < CACHE_COUNT; i++) {
+    if (readCache[i].fd == fd && readCache[i].pid >= pid &&
+        readCache[i].lastAccessed != 0) {
+       readCache[i].fd = 0;
+       readCache[i].pid = 0;
+       readCache[i].lastAccessed = 0;
+       readCache[i].dirty = false;
+    }
+  }
+
+  epid = pid;
+
+  return 0;
+}
+
 RC PageFile::seek(PageId pid) const
 {
   return (::lseek(fd, pid * PAGE_SIZE, SEEK_SET) < 0) ? RC_FILE_SEEK_FAILED : 0;
 }
 
-RC PageFile::write(PageId pid, const void* buffer)
+RC PageFile::evictSlot(int& slot)
 {
   RC rc;
-  if (pid < 0) return RC_INVALID_PID; 
 
-  // seek to the location of the page
-  if ((rc = seek(pid)) < 0) return rc;
+  // pick an empty slot or the least recently used one
+  slot = 0;
+  for (int i = 0; i < CACHE_COUNT; i++) {
+    if (readCache[i].lastAccessed == 0) {
+      slot = i;
+      break;
+    }
+    if (readCache[i].lastAccessed < readCache[slot].lastAccessed) {
+      slot = i;
+    }
+  }
 
-  // write the buffer to the disk page
-  if (::write(fd, buffer, PAGE_SIZE) < 0) return RC_FILE_WRITE_FAILED;
+  // the old page may belong to any open file
+  if ((rc = writeSlot(slot)) < 0) return rc;
+  readCache[slot].fd = 0;
+  readCache[slot].pid = 0;
+  readCache[slot].lastAccessed = 0;
 
-  // if the page is in read cache, invalidate it
+  return 0;
+}
+
+RC PageFile::writeSlot(int slot)
+{
+  struct cacheStruct& c = readCache[slot];
+
+  if (c.lastAccessed == 0 || !c.dirty) return 0;
+  if (::pwrite(c.fd, c.buffer, PAGE_SIZE, (off_t) c.pid * PAGE_SIZE) != PAGE_SIZE) {
+    return RC_FILE_WRITE_FAILED;
+  }
+  c.dirty = false;
+
+  // increase page write count
+  writeCount++;
+
+  return 0;
+}
+
+RC PageFile::write(PageId pid, const void* buffer)
+{
+  RC rc;
+  if (pid < 0) return RC_INVALID_PID; 
+
+  // find the page in the cache or a slot to bring it in
+  int slot = -1;
   for (int i = 0; i < CACHE_COUNT; i++) {
     if (readCache[i].fd == fd && readCache[i].pid == pid &&
         readCache[i].lastAccessed != 0) {
-       readCache[i].fd = 0;
-       readCache[i].pid = 0;
-       readCache[i].lastAccessed = 0;
+       slot = i;
        break;
     }
   }
+  if (slot < 0) {
+    if ((rc = evictSlot(slot)) < 0) return rc;
+    readCache[slot].fd = fd;
+    readCache[slot].pid = pid;
+  }
+
+  // the page goes to the disk later, when it is evicted or the file is closed
+  memcpy(readCache[slot].buffer, buffer, PAGE_SIZE);
+  readCache[slot].lastAccessed = ++cacheClock;
+  readCache[slot].dirty = true;
 
   // if the written pid >= end pid, update the end pid
   if (pid >= epid) epid = pid + 1;
 
-  // increase page write count
-  writeCount++;
-
   return 0;
 }
 
@@ -153,22 +234,15 @@ RC PageFile::read(PageId pid, void* buffer) const
   if ((rc = seek(pid)) < 0) return rc;
   
   // find the cache slot to evict
-  int toEvict = 0; 
-  for (int i = 0; i < CACHE_COUNT; i++) {
-    if (readCache[i].lastAccessed == 0) {
-      toEvict = i;
-      break;
-    }
-    if (readCache[i].lastAccessed < readCache[toEvict].lastAccessed) {
-      toEvict = i;
-    }
-  }
+  int toEvict;
+  if ((rc = evictSlot(toEvict)) < 0) return rc;
   readCache[toEvict].fd = fd;
   readCache[toEvict].pid = pid;
   readCache[toEvict].lastAccessed = ++cacheClock;
  
   // read the page to cache first and copy it to the buffer
   if (::read(fd, readCache[toEvict].buffer, PAGE_SIZE) < 0) {
+    readCache[toEvict].lastAccessed = 0;
     return RC_FILE_READ_FAILED;
   }
   memcpy(buffer, readCache[toEvict].buffer, PAGE_SIZE);
@@ -36,7 +36,8 @@ class PageFile {
   RC open(const std::string& filename, char mode);
 
   /**
-   * close the file.
+   * write the modified pages of the file in the cache to the disk
+   * and close the file.
    * @return error code. 0 if no error
    */
   RC close();
@@ -53,6 +54,9 @@ class PageFile {
    * write the memory buffer to the disk page.
    * if (pid >= endPid()), the file is expanded such that
    * endPid() becomes (pid + 1).
+   * the page is kept in the cache and written to the disk when it is
+   * evicted or when the file is closed, so that repeated writes to the
+   * same page cost only one disk write.
    * @param pid[IN] page to write to
    * @param buffer[IN] the content to write
    * @return error code. 0 if no error
@@ -66,11 +70,25 @@ class PageFile {
    */
   PageId endPid() const;
 
+  /**
+   * shrink the file so that endPid() becomes pid.
+   * the pages from pid on are discarded.
+   * @param pid[IN] the new end pid of the file
+   * @return error code. 0 if no error
+   */
+  RC truncate(PageId pid);
+
   /**
    * @return the total # of disk reads
    */
   static int getPageReadCount()  { return readCount; }
   
+  /**
+   * write all modified pages of the file in the cache to the disk.
+   * @return error code. 0 if no error
+   */
+  RC flush();
+
   /**
    * @return the total # of disk writes
    */
@@ -85,6 +103,21 @@ class PageFile {
    */
   RC seek(PageId pid) const;
 
+  /**
+   * choose the cache slot for a new page, writing its old page
+   * to the disk if it was modified.
+   * @param slot[OUT] the cache slot to use
+   * @return error code. 0 if no error
+   */
+  static RC evictSlot(int& slot);
+
+  /**
+   * write the page in a cache slot to the disk if it was modified.
+   * @param slot[IN] the cache slot to write
+   * @return error code. 0 if no error
+   */
+  static RC writeSlot(int slot);
+
  private:
   int     fd;     // file descriptor of the associated unix file
   PageId  epid;   // (last page id + 1) of the file
@@ -102,6 +135,7 @@ class PageFile {
     PageId pid;             // page id of the cached page
     int    lastAccessed;    // the last time the cached page was accessed
                             //   (lastAccessed == 0) means that the buffer is empty
+    bool   dirty;           // true if the page has not been written to the disk
     char buffer[PAGE_SIZE]; // the buffer used for caching
   } readCache[CACHE_COUNT];
 
@@ -9,6 +9,7 @@
 
 #include "Bruinbase.h"
 #include "RecordFile.h"
+#include "ValueDictionary.h"
 #include <cstring>
 
 using std::string;
@@ -26,6 +27,15 @@ static void readSlot(const char* page, int n, int& key, std::string& value);
 // write the record to the n'th slot in the page
 static void writeSlot(char* page, int n, int key, const std::string& value);
 
+// read/write the (key, code) record in the n'th slot of a page
+// of a file with a dictionary
+static void readCodedSlot(const char* page, int n, int& key, int& code);
+static void writeCodedSlot(char* page, int n, int key, int code);
+
+// check or set the tombstone of the n'th slot in the page
+static bool isDeleted(const char* page, int n);
+static void setDeleted(char* page, int n);
+
 // get # records stored in the page
 static int getRecordCount(const char* page);
 
@@ -107,6 +117,8 @@ RecordFile::RecordFile()
 {
   erid.pid = 0;
   erid.sid = 0;
+  dict = NULL;
+  recordsPerPage = RECORDS_PER_PAGE;
 }
 
 RecordFile::RecordFile(const string& filename, char mode)
@@ -115,10 +127,19 @@ RecordFile::RecordFile(const string& filename, char mode)
 }
 
 RC RecordFile::open(const string& filename, char mode)
+{
+  return open(filename, mode, NULL);
+}
+
+RC RecordFile::open(const string& filename, char mode, ValueDictionary* dict)
 {
   RC   rc;
   char page[PageFile::PAGE_SIZE];
 
+  // with a dictionary, a slot holds the code of the value
+  this->dict = dict;
+  recordsPerPage = (dict == NULL) ? RECORDS_PER_PAGE : CODED_RECORDS_PER_PAGE;
+
   // open the page file
   if ((rc = pf.open(filename, mode)) < 0) return rc;
   
@@ -148,7 +169,7 @@ RC RecordFile::open(const string& filename, char mode)
 
   // get # records in the last page
   erid.sid = getRecordCount(page);
-  if (erid.sid >= RECORDS_PER_PAGE) {
+  if (erid.sid >= recordsPerPage) {
     // the last page is full. advance the end record id to the next page.
     erid.pid++;
     erid.sid = 0;
@@ -161,6 +182,7 @@ RC RecordFile::close()
 {
   erid.pid = 0;
   erid.sid = 0;
+  dict = NULL;
 
   return pf.close();
 }
@@ -172,22 +194,56 @@ RC RecordFile::read(const RecordId& rid, int& key, string& value) const
   
   // check whether the rid is in the valid range
   if (rid.pid < 0 || rid.pid > erid.pid) return RC_INVALID_RID;
-  if (rid.sid < 0 || rid.sid >= RecordFile::RECORDS_PER_PAGE) return RC_INVALID_RID;
+  if (rid.sid < 0 || rid.sid >= recordsPerPage) return RC_INVALID_RID;
   if (rid >= erid) return RC_INVALID_RID;
   
   // read the page containing the record
   if ((rc = pf.read(rid.pid, page)) < 0) return rc;
 
+  if (isDeleted(page, rid.sid)) return RC_NO_SUCH_RECORD;
+
   // read the record from the slot in the page
+  if (dict != NULL) {
+    int code;
+    readCodedSlot(page, rid.sid, key, code);
+    return dict->decode(code, value);
+  }
   readSlot(page, rid.sid, key, value);
 
   return 0;
 }
 
+RC RecordFile::readCode(const RecordId& rid, int& key, int& code) const
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  if (dict == NULL) return RC_INVALID_ATTRIBUTE;
+
+  // check whether the rid is in the valid range
+  if (rid.pid < 0 || rid.pid > erid.pid) return RC_INVALID_RID;
+  if (rid.sid < 0 || rid.sid >= recordsPerPage) return RC_INVALID_RID;
+  if (rid >= erid) return RC_INVALID_RID;
+
+  // read the page containing the record
+  if ((rc = pf.read(rid.pid, page)) < 0) return rc;
+
+  if (isDeleted(page, rid.sid)) return RC_NO_SUCH_RECORD;
+  readCodedSlot(page, rid.sid, key, code);
+
+  return 0;
+}
+
 RC RecordFile::append(int key, const std::string& value, RecordId& rid)
 {
   RC   rc;
   char page[PageFile::PAGE_SIZE];
+  int  code;
+
+  // with a dictionary, we store the code of the value truncated
+  // the same way as writeSlot() does
+  if (dict != NULL &&
+      (rc = dict->encode(value.substr(0, MAX_VALUE_LENGTH - 1), code)) < 0) return rc;
 
   // unless we are writing to the the first slot of an empty page,
   // we have to read the page first
@@ -200,7 +256,10 @@ RC RecordFile::append(int key, const std::string& value, RecordId& rid)
   }
     
   // write the record to the first empty slot 
-  writeSlot(page, erid.sid, key, value);
+  if (dict != NULL)
+    writeCodedSlot(page, erid.sid, key, code);
+  else
+    writeSlot(page, erid.sid, key, value);
 
   // the first four bytes in the page stores # records in the page.
   // update this number.
@@ -213,7 +272,116 @@ RC RecordFile::append(int key, const std::string& value, RecordId& rid)
   rid = erid;
 
   // advance the end record id by one to the next empty slot
-  ++erid;
+  next(erid);
+
+  return 0;
+}
+
+RC RecordFile::update(const RecordId& rid, const std::string& value)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+  int  key, code, oldCode;
+  std::string oldValue;
+
+  // check whether the rid is in the valid range
+  if (rid.pid < 0 || rid.pid > erid.pid) return RC_INVALID_RID;
+  if (rid.sid < 0 || rid.sid >= recordsPerPage) return RC_INVALID_RID;
+  if (rid >= erid) return RC_INVALID_RID;
+
+  if (dict != NULL &&
+      (rc = dict->encode(value.substr(0, MAX_VALUE_LENGTH - 1), code)) < 0) return rc;
+
+  if ((rc = pf.read(rid.pid, page)) < 0) return rc;
+  if (isDeleted(page, rid.sid)) return RC_NO_SUCH_RECORD;
+
+  // rewrite the slot with the old key and the new value.
+  // a page whose value does not change is not written.
+  if (dict != NULL) {
+    readCodedSlot(page, rid.sid, key, oldCode);
+    if (oldCode == code) return 0;
+    writeCodedSlot(page, rid.sid, key, code);
+  } else {
+    readSlot(page, rid.sid, key, oldValue);
+    if (oldValue == value.substr(0, MAX_VALUE_LENGTH - 1)) return 0;
+    writeSlot(page, rid.sid, key, value);
+  }
+
+  return pf.write(rid.pid, page);
+}
+
+RC RecordFile::remove(const RecordId& rid)
+{
+  RC   rc;
+  char page[PageFile::PAGE_SIZE];
+
+  // check whether the rid is in the valid range
+  if (rid.pid < 0 || rid.pid > erid.pid) return RC_INVALID_RID;
+  if (rid.sid < 0 || rid.sid >= recordsPerPage) return RC_INVALID_RID;
+  if (rid >= erid) return RC_INVALID_RID;
+
+  if ((rc = pf.read(rid.pid, page)) < 0) return rc;
+  if (isDeleted(page, rid.sid)) return RC_NO_SUCH_RECORD;
+
+  setDeleted(page, rid.sid);
+
+  return pf.write(rid.pid, page);
+}
+
+RC RecordFile::compact(std::vector<RecordMove>& moves)
+{
+  RC         rc;
+  char       in[PageFile::PAGE_SIZE];   // the page we read the records from
+  char       out[PageFile::PAGE_SIZE];  // the page we move the records to
+  RecordId   rid;                       // where the next record goes
+  RecordMove move;
+  bool       shifted = false;           // true once a deleted slot is seen
+  int        slotSize = (dict == NULL) ? sizeof(int) + MAX_VALUE_LENGTH : 2 * sizeof(int);
+
+  moves.clear();
+  rid.pid = rid.sid = 0;
+  memset(out, 0, PageFile::PAGE_SIZE);
+
+  // the target page is never behind the page we read from,
+  // so we can compact the file in place
+  for (PageId pid = 0; pid < pf.endPid(); pid++) {
+    if ((rc = pf.read(pid, in)) < 0) return rc;
+
+    int count = getRecordCount(in);
+    for (int sid = 0; sid < count; sid++) {
+      if (isDeleted(in, sid)) {
+        shifted = true;
+        continue;
+      }
+
+      memcpy(out + sizeof(int) + slotSize * rid.sid, in + sizeof(int) + slotSize * sid, slotSize);
+      setRecordCount(out, rid.sid + 1);
+      if (pid != rid.pid || sid != rid.sid) {
+        memcpy(&move.key, in + sizeof(int) + slotSize * sid, sizeof(int));
+        move.from.pid = pid;
+        move.from.sid = sid;
+        move.to = rid;
+        moves.push_back(move);
+      }
+
+      // the pages before the first deleted slot stay as they are
+      if (rid.sid + 1 == recordsPerPage) {
+        if (shifted && (rc = pf.write(rid.pid, out)) < 0) return rc;
+        memset(out, 0, PageFile::PAGE_SIZE);
+      }
+      next(rid);
+    }
+  }
+
+  // write the last, partially filled page and drop the pages behind it
+  if (rid.sid > 0) {
+    if ((rc = pf.write(rid.pid, out)) < 0) return rc;
+    rc = pf.truncate(rid.pid + 1);
+  } else {
+    rc = pf.truncate(rid.pid);
+  }
+  if (rc < 0) return rc;
+  erid = rid;
 
   return 0;
 }
@@ -223,6 +391,28 @@ const RecordId& RecordFile::endRid() const
   return erid;
 }
 
+void RecordFile::next(RecordId& rid) const
+{
+  // if the end of a page is reached, move to the next page
+  if (++rid.sid >= recordsPerPage) {
+    rid.pid++;
+    rid.sid = 0;
+  }
+}
+
+static bool isDeleted(const char* page, int n)
+{
+  // the bitmap of deleted slots is stored in the last bytes of a page
+  const char* bitmap = page + PageFile::PAGE_SIZE - RecordFile::TOMBSTONE_SIZE;
+  return (bitmap[n >> 3] & (1 << (n & 7))) != 0;
+}
+
+static void setDeleted(char* page, int n)
+{
+  char* bitmap = page + PageFile::PAGE_SIZE - RecordFile::TOMBSTONE_SIZE;
+  bitmap[n >> 3] |= (char) (1 << (n & 7));
+}
+
 static int getRecordCount(const char* page)
 {
   int count;
@@ -276,3 +466,20 @@ static void writeSlot(char* page, int n, int key, const std::string& value)
     strcpy(ptr + sizeof(int), value.c_str());
   }
 }
+
+static void readCodedSlot(const char* page, int n, int& key, int& code)
+{
+  // a coded slot consists of two integers: the key and the code
+  const char *ptr = page + sizeof(int) + 2 * sizeof(int) * n;
+
+  memcpy(&key, ptr, sizeof(int));
+  memcpy(&code, ptr + sizeof(int), sizeof(int));
+}
+
+static void writeCodedSlot(char* page, int n, int key, int code)
+{
+  char *ptr = page + sizeof(int) + 2 * sizeof(int) * n;
+
+  memcpy(ptr, &key, sizeof(int));
+  memcpy(ptr + sizeof(int), &code, sizeof(int));
+}
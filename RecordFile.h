@@ -11,8 +11,11 @@
 #define RECORDFILE_H
 
 #include <string>
+#include <vector>
 #include "PageFile.h"
 
+class ValueDictionary;
+
 /**
  * The data structure for pointing to a particular record in a RecordFile.
  * A record id consists of pid (PageId) and sid (the slot number in the page)
@@ -22,6 +25,15 @@ typedef struct {
   int     sid;  // slot number. the first slot is 0
 } RecordId;
 
+/**
+ * a record moved from one slot to another by RecordFile::compact()
+ */
+typedef struct {
+  int      key;   // the key of the record
+  RecordId from;  // the old location of the record
+  RecordId to;    // the new location of the record
+} RecordMove;
+
 //
 // helper functions for RecordId
 // 
@@ -47,11 +59,18 @@ class RecordFile {
   // maximum length of the value field
   static const int MAX_VALUE_LENGTH = 100;  
 
+  // size of the bitmap at the end of a page that marks the deleted slots
+  static const int TOMBSTONE_SIZE = 16;
+
   // number of record slots per page
-  static const int RECORDS_PER_PAGE = (PageFile::PAGE_SIZE - sizeof(int))/ (sizeof(int) + MAX_VALUE_LENGTH);  
+  static const int RECORDS_PER_PAGE = (PageFile::PAGE_SIZE - sizeof(int) - TOMBSTONE_SIZE)/ (sizeof(int) + MAX_VALUE_LENGTH);  
     // Note that we subtract sizeof(int) from PAGE_SIZE because the first
     // four bytes in the page is used to store # records in the page.
 
+  // number of record slots per page when the values are stored as codes
+  // of a ValueDictionary. each slot is then a (key, code) pair.
+  static const int CODED_RECORDS_PER_PAGE = (PageFile::PAGE_SIZE - sizeof(int) - TOMBSTONE_SIZE)/ (2 * sizeof(int));
+
   RecordFile();
   RecordFile(const std::string& filename, char mode);
   
@@ -64,6 +83,18 @@ class RecordFile {
    */
   RC open(const std::string& filename, char mode);
 
+  /**
+   * open a file whose values are stored as codes of a dictionary.
+   * the values are encoded by append() and decoded by read().
+   * the dictionary has to be open (in 'w' mode if the file is appended to)
+   * as long as the file is open.
+   * @param filename[IN] the name of the file to open
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @param dict[IN] the dictionary of the value column. NULL if none
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename, char mode, ValueDictionary* dict);
+
   /**
    * close the file.
    * @return error code. 0 if no error
@@ -75,10 +106,20 @@ class RecordFile {
    * @param rid[IN] the id of the record to read
    * @param key[OUT] the record key
    * @param value[OUT] the record valu
-   * @return error code. 0 if no error
+   * @return error code. 0 if no error, RC_NO_SUCH_RECORD if the record was deleted
    */
   RC read(const RecordId& rid, int& key, std::string& value) const;
 
+  /**
+   * read a record without decoding its value.
+   * only for a file opened with a dictionary.
+   * @param rid[IN] the id of the record to read
+   * @param key[OUT] the record key
+   * @param code[OUT] the dictionary code of the record value
+   * @return error code. 0 if no error, RC_NO_SUCH_RECORD if the record was deleted
+   */
+  RC readCode(const RecordId& rid, int& key, int& code) const;
+
   /**
    * append a new record at the end of the file.
    * note that RecordFile does not have write() function.
@@ -90,15 +131,56 @@ class RecordFile {
    */
   RC append(int key, const std::string& value, RecordId& rid);
 
+  /**
+   * overwrite the value of a record in its slot. the key stays the same.
+   * the slots have a fixed size, so the new value always fits
+   * (it is truncated the same way as in append()).
+   * @param rid[IN] the id of the record to update
+   * @param value[IN] the new value of the record
+   * @return error code. RC_NO_SUCH_RECORD if the record was deleted
+   */
+  RC update(const RecordId& rid, const std::string& value);
+
+  /**
+   * delete a record. the slot of the record is marked with a tombstone
+   * and is not reused until the file is compacted.
+   * @param rid[IN] the id of the record to delete
+   * @return error code. RC_NO_SUCH_RECORD if the record was already deleted
+   */
+  RC remove(const RecordId& rid);
+
+  /**
+   * move the records that are not deleted to the front of the file,
+   * closing the slots of deleted records, and shrink the file.
+   * the order of the records does not change.
+   * @param moves[OUT] the records that were moved to another slot
+   * @return error code. 0 if no error
+   */
+  RC compact(std::vector<RecordMove>& moves);
+
   /**
    * note the +1 part. The rid of the last record is endRid()-1.
    * @return (last record id + 1) of the RecordFile
    */
   const RecordId& endRid() const;
 
+  /**
+   * move a record id to the next record slot of the file.
+   * use this instead of ++rid to iterate over a file with a dictionary.
+   * @param rid[IN/OUT] the record id to advance
+   */
+  void next(RecordId& rid) const;
+
+  /**
+   * @return the number of record slots in a page of the file
+   */
+  int getRecordsPerPage() const { return recordsPerPage; }
+
  private:
   PageFile pf;     // the PageFile used to store the records
   RecordId erid;   // the last record id of the file + 1
+  ValueDictionary* dict;  // the dictionary of the value column (NULL if none)
+  int recordsPerPage;     // # record slots per page
 };
 
 #endif // RECORDFILE_H
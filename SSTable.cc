@@ -0,0 +1,360 @@
+/**
+ * SSTable: an immutable table file with the tuples sorted by key.
+ *
+ * Block i of the table is page i of the file. A block starts with the
+ * number of its tuples and its first key. Each tuple follows as the
+ * difference from the previous key (a varint), the length of the value
+ * (one byte) and the value itself. The block index follows the blocks,
+ * INFOS_PER_PAGE entries per page, then the Bloom filter, one page per
+ * PageFile::PAGE_SIZE * 8 / BITS_PER_TUPLE keys. The last page is the footer.
+ */
+
+#include "Bruinbase.h"
+#include "SSTable.h"
+#include "RecordFile.h"
+#include <cstdio>
+#include <cstring>
+
+using std::string;
+
+// the first int of the footer. marks a complete file.
+static const int SSTABLE_MAGIC = 0x53535431;
+
+// # bytes of the varint encoding of n
+static int varintSize(unsigned n);
+
+// write n as a varint to buf and return the # bytes written
+static int writeVarint(char* buf, unsigned n);
+
+// read a varint from buf into n and return the # bytes read
+static int readVarint(const char* buf, unsigned& n);
+
+SSTable::SSTable()
+{
+  mode = 'r';
+  tupleCount = 0;
+  used = 2 * sizeof(int);
+  cachedBlock = -1;
+  bloomPid = 0;
+  bloomPages = 0;
+}
+
+RC SSTable::create(const string& filename)
+{
+  RC rc;
+
+  // start from an empty file
+  remove(filename.c_str());
+  if ((rc = pf.open(filename, 'w')) < 0) return rc;
+
+  mode = 'w';
+  tupleCount = 0;
+  blocks.clear();
+  writtenKeys.clear();
+  memset(page, 0, PageFile::PAGE_SIZE);
+  used = 2 * sizeof(int);
+  cachedBlock = -1;
+
+  return 0;
+}
+
+RC SSTable::open(const string& filename)
+{
+  RC     rc;
+  int    magic, blockCount;
+  PageId indexPid;
+
+  if ((rc = pf.open(filename, 'r')) < 0) return rc;
+
+  mode = 'r';
+  blocks.clear();
+  cachedBlock = -1;
+
+  // the footer tells where the block index is
+  if (pf.endPid() == 0 || (rc = pf.read(pf.endPid() - 1, page)) < 0) {
+    pf.close();
+    return (rc < 0) ? rc : RC_INVALID_FILE_FORMAT;
+  }
+  memcpy(&magic, page, sizeof(int));
+  memcpy(&blockCount, page + sizeof(int), sizeof(int));
+  memcpy(&tupleCount, page + 2 * sizeof(int), sizeof(int));
+  memcpy(&indexPid, page + 3 * sizeof(int), sizeof(PageId));
+  memcpy(&bloomPid, page + 4 * sizeof(int), sizeof(PageId));
+  memcpy(&bloomPages, page + 5 * sizeof(int), sizeof(int));
+  if (magic != SSTABLE_MAGIC || blockCount < 0) {
+    pf.close();
+    return RC_INVALID_FILE_FORMAT;
+  }
+
+  // read the block index into memory
+  blocks.resize(blockCount);
+  for (int i = 0; i < blockCount; i += INFOS_PER_PAGE) {
+    if ((rc = pf.read(indexPid + i / INFOS_PER_PAGE, page)) < 0) {
+      pf.close();
+      return rc;
+    }
+    int n = (blockCount - i < INFOS_PER_PAGE) ? blockCount - i : INFOS_PER_PAGE;
+    memcpy(&blocks[i], page, n * sizeof(BlockInfo));
+  }
+
+  return 0;
+}
+
+RC SSTable::close()
+{
+  RC     rc;
+  PageId pid;
+  int    magic = SSTABLE_MAGIC;
+  int    blockCount = blocks.size();
+
+  if (mode == 'w') {
+    if ((rc = flushBlock()) < 0) {
+      pf.close();
+      return rc;
+    }
+
+    // the block index goes behind the blocks and the footer behind the index
+    pid = blockCount;
+    for (int i = 0; i < blockCount; i += INFOS_PER_PAGE) {
+      int n = (blockCount - i < INFOS_PER_PAGE) ? blockCount - i : INFOS_PER_PAGE;
+      memset(page, 0, PageFile::PAGE_SIZE);
+      memcpy(page, &blocks[i], n * sizeof(BlockInfo));
+      if ((rc = pf.write(pid + i / INFOS_PER_PAGE, page)) < 0) {
+        pf.close();
+        return rc;
+      }
+    }
+
+    // the Bloom filter goes behind the index
+    bloomPid = pf.endPid();
+    bloomPages = (tupleCount * BITS_PER_TUPLE + PageFile::PAGE_SIZE * 8 - 1) / (PageFile::PAGE_SIZE * 8);
+    std::vector<char> filter(bloomPages * PageFile::PAGE_SIZE, 0);
+    for (unsigned i = 0; i < writtenKeys.size(); i++) {
+      PageId bpid;
+      int    bits[HASH_COUNT];
+      bloomBits(writtenKeys[i], bpid, bits);
+      char* p = &filter[(bpid - bloomPid) * PageFile::PAGE_SIZE];
+      for (int h = 0; h < HASH_COUNT; h++)
+        p[bits[h] / 8] |= (char) (1 << (bits[h] % 8));
+    }
+    for (int i = 0; i < bloomPages; i++) {
+      if ((rc = pf.write(bloomPid + i, &filter[i * PageFile::PAGE_SIZE])) < 0) {
+        pf.close();
+        return rc;
+      }
+    }
+
+    memset(page, 0, PageFile::PAGE_SIZE);
+    memcpy(page, &magic, sizeof(int));
+    memcpy(page + sizeof(int), &blockCount, sizeof(int));
+    memcpy(page + 2 * sizeof(int), &tupleCount, sizeof(int));
+    memcpy(page + 3 * sizeof(int), &pid, sizeof(PageId));
+    memcpy(page + 4 * sizeof(int), &bloomPid, sizeof(PageId));
+    memcpy(page + 5 * sizeof(int), &bloomPages, sizeof(int));
+    if ((rc = pf.write(pf.endPid(), page)) < 0) {
+      pf.close();
+      return rc;
+    }
+    mode = 'r';
+  }
+
+  blocks.clear();
+  writtenKeys.clear();
+  keys.clear();
+  values.clear();
+  cachedBlock = -1;
+
+  return pf.close();
+}
+
+RC SSTable::append(int key, const string& value)
+{
+  RC       rc;
+  int      count;
+  unsigned delta;
+  string   v = value.substr(0, RecordFile::MAX_VALUE_LENGTH - 1);
+
+  if (mode != 'w') return RC_INVALID_FILE_MODE;
+
+  // the last key of the last block is the last key appended,
+  // also when the block was just written out
+  if (!blocks.empty() && key < blocks.back().lastKey) return RC_INVALID_ATTRIBUTE;
+  memcpy(&count, page, sizeof(int));
+
+  // start a new block if the tuple does not fit in this one
+  delta = (count > 0) ? (unsigned) key - (unsigned) blocks.back().lastKey : 0;
+  if (used + varintSize(delta) + 1 + (int) v.size() > PageFile::PAGE_SIZE) {
+    if ((rc = flushBlock()) < 0) return rc;
+    count = 0;
+    delta = 0;
+  }
+
+  if (count == 0) {
+    BlockInfo info = { key, key };
+    blocks.push_back(info);
+    memcpy(page + sizeof(int), &key, sizeof(int));
+  }
+
+  used += writeVarint(page + used, delta);
+  page[used++] = (char) v.size();
+  memcpy(page + used, v.data(), v.size());
+  used += v.size();
+
+  count++;
+  memcpy(page, &count, sizeof(int));
+  blocks.back().lastKey = key;
+  writtenKeys.push_back(key);
+  tupleCount++;
+
+  return 0;
+}
+
+RC SSTable::flushBlock()
+{
+  RC  rc;
+  int count;
+
+  memcpy(&count, page, sizeof(int));
+  if (count == 0) return 0;
+  if ((rc = pf.write(blocks.size() - 1, page)) < 0) return rc;
+
+  memset(page, 0, PageFile::PAGE_SIZE);
+  used = 2 * sizeof(int);
+
+  return 0;
+}
+
+RC SSTable::readBlock(PageId block)
+{
+  RC       rc;
+  int      count, key, pos;
+  unsigned delta;
+
+  if (block == cachedBlock) return 0;
+  if ((rc = pf.read(block, page)) < 0) return rc;
+
+  memcpy(&count, page, sizeof(int));
+  memcpy(&key, page + sizeof(int), sizeof(int));
+  keys.resize(count);
+  values.resize(count);
+  pos = 2 * sizeof(int);
+  for (int i = 0; i < count; i++) {
+    if (pos >= PageFile::PAGE_SIZE) return RC_INVALID_FILE_FORMAT;
+    pos += readVarint(page + pos, delta);
+    key = (int) ((unsigned) key + delta);
+    int len = (unsigned char) page[pos++];
+    keys[i] = key;
+    values[i].assign(page + pos, len);
+    pos += len;
+  }
+  cachedBlock = block;
+
+  return 0;
+}
+
+RC SSTable::locate(int searchKey, IndexCursor& cursor)
+{
+  RC  rc;
+  int lo = 0, hi = blocks.size();
+
+  // find the first block whose last key is not smaller than searchKey
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (blocks[mid].lastKey < searchKey) lo = mid + 1;
+    else hi = mid;
+  }
+  cursor.pid = lo;
+  cursor.eid = 0;
+  if (lo == (int) blocks.size()) return RC_NO_SUCH_RECORD;
+
+  if ((rc = readBlock(lo)) < 0) return rc;
+  while (keys[cursor.eid] < searchKey) cursor.eid++;
+
+  return (keys[cursor.eid] == searchKey) ? 0 : RC_NO_SUCH_RECORD;
+}
+
+RC SSTable::readForward(IndexCursor& cursor, int& key, string& value)
+{
+  RC rc;
+
+  while (true) {
+    if (cursor.pid < 0 || cursor.pid >= (int) blocks.size()) return RC_END_OF_TREE;
+    if ((rc = readBlock(cursor.pid)) < 0) return rc;
+    if (cursor.eid < (int) keys.size()) break;
+    cursor.pid++;
+    cursor.eid = 0;
+  }
+
+  key = keys[cursor.eid];
+  value = values[cursor.eid];
+  cursor.eid++;
+
+  return 0;
+}
+
+bool SSTable::mayOverlap(int lo, int hi) const
+{
+  return !blocks.empty() && blocks.front().firstKey <= hi && blocks.back().lastKey >= lo;
+}
+
+bool SSTable::mayContain(int key)
+{
+  PageId pid;
+  int    bits[HASH_COUNT];
+
+  if (bloomPages == 0) return true;
+
+  bloomBits(key, pid, bits);
+  if (pf.read(pid, page) < 0) return true;
+
+  for (int h = 0; h < HASH_COUNT; h++) {
+    if (!(page[bits[h] / 8] & (1 << (bits[h] % 8)))) return false;
+  }
+  return true;
+}
+
+void SSTable::bloomBits(int key, PageId& pid, int bits[HASH_COUNT]) const
+{
+  // one hash picks the page, two more generate the bits in it
+  unsigned h = (unsigned) key * 2654435761u;
+  unsigned h1 = (h ^ (h >> 16)) * 0x45d9f3bu;
+  unsigned h2 = ((h1 ^ (h1 >> 16)) * 0x45d9f3bu) | 1;
+
+  pid = bloomPid + (h >> 8) % bloomPages;
+  for (int i = 0; i < HASH_COUNT; i++)
+    bits[i] = (h1 + i * h2) % (PageFile::PAGE_SIZE * 8);
+}
+
+static int varintSize(unsigned n)
+{
+  int size = 1;
+  while (n >= 0x80) {
+    n >>= 7;
+    size++;
+  }
+  return size;
+}
+
+static int writeVarint(char* buf, unsigned n)
+{
+  int size = 0;
+  while (n >= 0x80) {
+    buf[size++] = (char) ((n & 0x7f) | 0x80);
+    n >>= 7;
+  }
+  buf[size++] = (char) n;
+  return size;
+}
+
+static int readVarint(const char* buf, unsigned& n)
+{
+  int size = 0, shift = 0;
+  n = 0;
+  while (true) {
+    unsigned char b = (unsigned char) buf[size++];
+    n |= (unsigned) (b & 0x7f) << shift;
+    if (!(b & 0x80)) break;
+    shift += 7;
+  }
+  return size;
+}
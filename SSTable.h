@@ -0,0 +1,142 @@
+/**
+ * SSTable: an immutable table file with the tuples sorted by key.
+ *
+ * A frozen table is written once, in key order, and then only read. The
+ * tuples are packed into blocks of one page each: the keys are stored as
+ * variable-length deltas from the previous key and the values with their
+ * length instead of a fixed-size slot. A sparse block index keeps the first
+ * and the last key of every block, and a footer in the last page of the
+ * file tells where the index starts. open() reads the footer and the index
+ * into memory, so a lookup is a binary search in memory plus one block read.
+ * A blocked Bloom filter on the keys follows the index; it tells with one
+ * page read that a key is not in the file.
+ */
+
+#ifndef SSTABLE_H
+#define SSTABLE_H
+
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "PageFile.h"
+#include "BTreeIndex.h"
+
+class SSTable {
+ public:
+
+  // the position of a scan: the block and the tuple in it
+  typedef IndexCursor Cursor;
+
+  SSTable();
+
+  /**
+   * create a new, empty table file for writing.
+   * an existing file with the same name is overwritten.
+   * @param filename[IN] the name of the table file
+   * @return error code. 0 if no error
+   */
+  RC create(const std::string& filename);
+
+  /**
+   * open an existing table file for reading
+   * and read its block index into memory.
+   * @param filename[IN] the name of the table file
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename);
+
+  /**
+   * write the last block, the block index and the footer of a new file,
+   * and close the file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * append a tuple to a new file. the tuples must come in key order.
+   * @param key[IN] the key of the tuple
+   * @param value[IN] the value of the tuple
+   * @return error code. RC_INVALID_ATTRIBUTE if key is out of order
+   */
+  RC append(int key, const std::string& value);
+
+  /**
+   * set the cursor to the first tuple whose key is not smaller than
+   * searchKey. cursor.pid is the block and cursor.eid the tuple in it.
+   * @param searchKey[IN] the key to find
+   * @param cursor[OUT] the cursor pointing to the tuple
+   * @return 0 if searchKey is found. Othewise an error code
+   */
+  RC locate(int searchKey, IndexCursor& cursor);
+
+  /**
+   * read the tuple at the cursor and move the cursor forward.
+   * @param cursor[IN/OUT] the cursor pointing to a tuple
+   * @param key[OUT] the key of the tuple
+   * @param value[OUT] the value of the tuple
+   * @return error code. RC_END_OF_TREE at the end of the table
+   */
+  RC readForward(IndexCursor& cursor, int& key, std::string& value);
+
+  /**
+   * check with the block index whether the file may have a key in [lo, hi].
+   * @param lo[IN] the smallest key of the range
+   * @param hi[IN] the largest key of the range
+   * @return false if no key of the file is in the range
+   */
+  bool mayOverlap(int lo, int hi) const;
+
+  /**
+   * check with the Bloom filter whether the file may have a key.
+   * @param key[IN] the key to look for
+   * @return false if the key is definitely not in the file
+   */
+  bool mayContain(int key);
+
+  /**
+   * @return the number of tuples in the table
+   */
+  int getTupleCount() const { return tupleCount; }
+
+ private:
+  // the first and the last key of a block
+  struct BlockInfo {
+    int firstKey;
+    int lastKey;
+  };
+
+  // number of BlockInfo entries stored in one index page
+  static const int INFOS_PER_PAGE = PageFile::PAGE_SIZE / sizeof(BlockInfo);
+
+  // bits of the Bloom filter reserved for each tuple
+  static const int BITS_PER_TUPLE = 10;
+
+  // number of bits set for each key
+  static const int HASH_COUNT = 7;
+
+  // compute the page of the Bloom filter and the bits in it for a key
+  void bloomBits(int key, PageId& pid, int bits[HASH_COUNT]) const;
+
+  // read a block and decode its tuples into keys and values
+  RC readBlock(PageId block);
+
+  // write the block being built to the disk
+  RC flushBlock();
+
+  PageFile pf;         // the PageFile used to store the table
+  char     mode;       // 'w' while a new file is written, 'r' afterwards
+  int      tupleCount; // the number of tuples in the table
+  std::vector<BlockInfo> blocks;  // the block index
+  std::vector<int>       writtenKeys;  // the keys of a new file, for its Bloom filter
+  PageId   bloomPid;   // the first page of the Bloom filter
+  int      bloomPages; // # pages of the Bloom filter (0 if there is none)
+
+  // the block being built ('w') or the last block read ('r')
+  char     page[PageFile::PAGE_SIZE];
+  int      used;       // # bytes used in page
+  PageId   cachedBlock;             // the block decoded in keys and values
+  std::vector<int>         keys;    // the keys of cachedBlock
+  std::vector<std::string> values;  // the values of cachedBlock
+};
+
+#endif // SSTABLE_H
@@ -10,11 +10,22 @@
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <climits>
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <map>
+#include <set>
 #include "Bruinbase.h"
 #include "SqlEngine.h"
 #include "BTreeIndex.h"
+#include "ZoneMap.h"
+#include "BloomFilter.h"
+#include "ValueDictionary.h"
+#include "TableWriter.h"
+#include "SSTable.h"
+#include "LSMTable.h"
+#include "CachedTable.h"
 
 using namespace std;
 
@@ -22,6 +33,57 @@ using namespace std;
 extern FILE* sqlin;
 int sqlparse(void);
 
+// the tables cached by CACHE TABLE, and the ones among them that have been
+// written since they were read. a stale cache is read again by the next
+// select on the table.
+static map<string, CachedTable> cachedTables;
+static set<string> staleTables;
+
+// mark the cache of a table stale before the table is written
+static void invalidateCache(const string& table);
+
+// check whether any tuple summarized by the zone can satisfy all conditions
+static bool zoneMayMatch(const ZoneMap::Zone& zone, const vector<SelCond>& cond);
+
+// check the equality conditions against the Bloom filter of a zone
+// (or of the whole table when zid < 0)
+static bool bloomMayMatch(const BloomFilter& bf, int zid, const vector<SelCond>& cond);
+
+// compute the range [lo, hi] of keys allowed by the conditions.
+// return false if no key can satisfy them.
+static bool keyRange(const vector<SelCond>& cond, int& lo, int& hi);
+
+// order the tuples of a clustered load by key
+static bool compareKeys(const pair<int, string>& a, const pair<int, string>& b);
+
+// check whether a tuple satisfies all conditions
+static bool tupleMatches(int key, const string& value, const vector<SelCond>& cond);
+
+// run a SELECT on a table sorted by key that is its own index: an
+// index-organized (BTreeTable), log-structured (LSMTable) or frozen
+// (SSTable) table
+template<class SortedTable>
+static RC selectSorted(SortedTable& st, int attr, const string& table, const vector<SelCond>& cond);
+
+// delete (value == NULL) or update the tuples of an index-organized
+// table that satisfy all conditions
+static RC modifyOrganized(const string& table, const vector<SelCond>& cond, const string* value);
+
+// delete (value == NULL) or update the tuples of a log-structured
+// table that satisfy all conditions
+static RC modifyLSM(const string& table, const vector<SelCond>& cond, const string* value);
+
+// print a tuple for the attribute in the SELECT clause
+static void printTuple(int attr, int key, const string& value);
+
+// read all tuples of a table of any kind in the order they are stored
+static RC readTable(const string& table, vector<pair<int, string> >& tuples);
+
+// find the tuples of a table that satisfy all conditions,
+// using the index of the table if it is given
+static RC findTuples(const RecordFile& rf, BTreeIndex* index, const vector<SelCond>& cond,
+                     vector<int>& keys, vector<RecordId>& rids);
+
 
 RC SqlEngine::run(FILE* commandline)
 {
@@ -50,27 +112,170 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
   int    count;
   int    diff;
 
+  ZoneMap       zm;       // zone map of the table, used by the table scan
+  ZoneMap::Zone zone;
+  bool          useZoneMap = false;
+  BloomFilter   bf;       // Bloom filters of the table, if it has them
+  bool          useBloom = false;
+  ValueDictionary dict;   // dictionary of the value column, if the table has one
+  bool          useDict;
+  vector<int>   codes;    // the dictionary code each condition compares with (-1 if none)
+  int           code;
+  bool          decoded;  // true if value holds the value of the current tuple
+  bool          clustered;  // true if the tuples are stored in key order
+  RecordId      start;      // where the table scan starts
+  bool          seeked;     // true if the index has chosen the start
+  int           lo, hi;     // the key range of a clustered table scan
+
+  // a cached table is served from memory
+  if (staleTables.count(table) > 0)
+    cache(table);
+  if (cachedTables.count(table) > 0)
+    return selectSorted(cachedTables[table], attr, table, cond);
+
+  // an index-organized, log-structured or frozen table is its own index
+  if (TableWriter::isOrganized(table)) {
+    BTreeTable tree;
+    if ((rc = tree.open(table + ".iot", 'r')) < 0) {
+      fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+      return rc;
+    }
+    rc = selectSorted(tree, attr, table, cond);
+    tree.close();
+    return rc;
+  }
+  if (TableWriter::isLSM(table)) {
+    LSMTable lsm;
+    if ((rc = lsm.open(table, 'r')) < 0) {
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+      return rc;
+    }
+    rc = selectSorted(lsm, attr, table, cond);
+    lsm.close();
+    return rc;
+  }
+  if (TableWriter::isFrozen(table)) {
+    SSTable sst;
+    if ((rc = sst.open(table + ".sst")) < 0) {
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+      return rc;
+    }
+    rc = selectSorted(sst, attr, table, cond);
+    sst.close();
+    return rc;
+  }
+
   // open the table file
-  if ((rc = rf.open(table + ".tbl", 'r')) < 0) {
+  useDict = (dict.open(table + ".dict", 'r') == 0);
+  if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+    if (useDict)
+      dict.close();
     fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
     return rc;
   }
+  clustered = (cond.size() > 0 && TableWriter::isClustered(table));
+  start.pid = start.sid = 0;
+  seeked = false;
 
   BTreeIndex index;
+
+  // a Bloom filter only helps equality conditions
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].comp == SelCond::EQ) {
+      useBloom = (bf.open(table + ".bf", 'r') == 0);
+      break;
+    }
+  }
+
+  // if the key or the value we are looking for is not in the table,
+  // no tuple can match and we do not need to look at the table at all
+  if (useBloom && !bloomMayMatch(bf, -1, cond)) {
+    if (attr == 4) {
+      fprintf(stdout, "%d\n", 0);
+    }
+    rc = 0;
+    goto exit_select;
+  }
+
+  // with a dictionary, an equality condition on the value compares codes.
+  // a value that is not in the dictionary is not in the table.
+  for (unsigned i = 0; useDict && i < cond.size(); i++) {
+    codes.push_back(-1);
+    if (cond[i].attr != 2 || (cond[i].comp != SelCond::EQ && cond[i].comp != SelCond::NE))
+      continue;
+    if (dict.find(cond[i].value, code) == 0) {
+      codes[i] = code;
+    } else if (cond[i].comp == SelCond::NE) {
+      // no tuple has a code that is not in the dictionary yet
+      codes[i] = dict.size();
+    } else {
+      if (attr == 4) {
+        fprintf(stdout, "%d\n", 0);
+      }
+      rc = 0;
+      goto exit_select;
+    }
+  }
+
   if ((index.open(table + ".idx", 'r')) != 0) {
     // no index exists for this table so we must
     // scan the table file from the beginning
     if (DEBUG)
       cout << "No index found..." << endl;
     no_index:
-    rid.pid = rid.sid = 0;
+    // skipping zones only pays off when there is something to check
+    if (cond.size() > 0 && !seeked)
+      useZoneMap = (zm.open(table + ".zm", 'r') == 0);
+
+    // the tuples of a clustered table are in key order,
+    // so the scan stops at the first key past the key range
+    if (clustered && !keyRange(cond, lo, hi)) {
+      if (attr == 4) {
+        fprintf(stdout, "%d\n", 0);
+      }
+      rc = 0;
+      goto exit_select;
+    }
+
+    rid = start;
     count = 0;
     while (rid < rf.endRid()) {
-      // read the tuple
-      if ((rc = rf.read(rid, key, value)) < 0) {
+      // at the start of a zone, skip all of its pages
+      // if none of its tuples can satisfy the conditions
+      if ((useZoneMap || useBloom) && rid.sid == 0 && rid.pid % ZoneMap::ZONE_PAGES == 0) {
+        int  zid = ZoneMap::zoneOf(rid);
+        bool skip = false;
+        if (useZoneMap && zid < zm.getZoneCount()) {
+          if ((rc = zm.read(zid, zone)) < 0) {
+            fprintf(stderr, "Error: while reading the zone map of table %s\n", table.c_str());
+            goto exit_select;
+          }
+          skip = !zoneMayMatch(zone, cond);
+        }
+        if (!skip && useBloom)
+          skip = !bloomMayMatch(bf, zid, cond);
+        if (skip) {
+          rid.pid += ZoneMap::ZONE_PAGES;
+          continue;
+        }
+      }
+
+      // read the tuple. with a dictionary, the value is decoded only when needed
+      if (useDict)
+        rc = rf.readCode(rid, key, code);
+      else
+        rc = rf.read(rid, key, value);
+      if (rc == RC_NO_SUCH_RECORD) {
+        // the tuple was deleted
+        goto next_tuple;
+      }
+      if (rc < 0) {
         fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
         goto exit_select;
       }
+      if (clustered && key > hi)
+        break;
+      decoded = !useDict;
 
       // check the conditions on the tuple
       for (unsigned i = 0; i < cond.size(); i++) {
@@ -80,6 +285,15 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
           diff = key - atoi(cond[i].value);
           break;
         case 2:
+          if (useDict && codes[i] >= 0) {
+            diff = (code != codes[i]);
+            break;
+          }
+          if (!decoded && (rc = dict.decode(code, value)) < 0) {
+            fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+            goto exit_select;
+          }
+          decoded = true;
           diff = strcmp(value.c_str(), cond[i].value);
           break;
         }
@@ -111,6 +325,11 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
       // increase matching tuple counter
       count++;
 
+      if (!decoded && (attr == 2 || attr == 3) && (rc = dict.decode(code, value)) < 0) {
+        fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+        goto exit_select;
+      }
+
       // print the tuple 
       switch (attr) {
       case 1:  // SELECT key
@@ -126,7 +345,7 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
 
       // move to the next tuple
       next_tuple:
-      ++rid;
+      rf.next(rid);
     }
 
       // print matching tuple count if "select count(*)"
@@ -141,8 +360,8 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
       cout << "Found index!" << endl;
     rid.pid = rid.sid = 0;
     count = 0;
-    int searchKey = -99999999;
-    int maxKey = 99999999;
+    int searchKey = INT_MIN;
+    int maxKey = INT_MAX;
     bool isEqualityComparison = false;
     bool isReadVal = false;
     bool isOnlyNotEqualsComparisons = true;
@@ -176,11 +395,12 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
       // then we should just iterate through all elements without using the index
       if (cond[i].comp != SelCond::NE)
         isOnlyNotEqualsComparisons = false;
-      // immediately search for this key if there is an equality comparison
+      // immediately search for this key if there is an equality comparison.
+      // the key may appear in several tuples, so we read all entries with it.
+      // the other conditions are still checked on every entry.
       if (cond[i].attr == 1 && cond[i].comp == SelCond::EQ) {
         isEqualityComparison = true;
-        searchKey = atoi(cond[i].value);
-        break;
+        searchKey = maxKey = atoi(cond[i].value);
       }
     }
     // check if only count(*) to save from doing unnecessary PageFile reads
@@ -198,117 +418,56 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
       cout << "isOnlyNotEqualsComparisons: " << isOnlyNotEqualsComparisons << endl; 
       cout << "isOnlyCountStar: " << isOnlyCountStar << endl;
     }
-    if (isOnlyNotEqualsComparisons && !isEqualityComparison)
+    if (isOnlyNotEqualsComparisons && !isEqualityComparison) {
+      index.close();
       goto no_index;
-
-    IndexCursor cursor;
-    index.locate(searchKey, cursor);
-    if (DEBUG)
-    {
-      cout << "searchKey: " << searchKey << endl;
-      cout << "cursor.pid: " << cursor.pid << endl;
-      cout << "cursor.eid: " << cursor.eid << endl;
     }
 
-    if (isEqualityComparison)
-    {
-        bool isEqual = true;
-        RC errorMsg = index.readForward(cursor, searchKey, rid);
-        if (errorMsg != 0)
-          return errorMsg;
-
-        if (DEBUG)
-        {
-          cout << "searchKey: " << searchKey << endl;
-          cout << "rid.pid: " << rid.pid << endl;
-          cout << "rid.sid: " << rid.sid << endl;
-        }
-        // read the tuple
-        if ((rc = rf.read(rid, searchKey, value)) < 0) {
-          fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
-          goto exit_select;
-        } 
+    // a clustered table is scanned from the first tuple in the key range,
+    // so the index only has to tell where that tuple is stored
+    if (clustered && !isOnlyCountStar && !isEqualityComparison) {
+      BTreeIndexCursor first;
+      RecordId         r;
+      int              k, firstKey;
 
-        if (DEBUG)
-        {
-          cout << "searchKey: " << searchKey << endl;
-          cout << "rid.pid: " << rid.pid << endl;
-          cout << "rid.sid: " << rid.sid << endl;
-          cout << "value: " << value << endl;
-          cout << "cond.size: " << cond.size() << endl;
+      if (first.locate(index, searchKey) < 0) {
+        // the table is read from its first tuple instead
+        start.pid = start.sid = 0;
+      } else if (first.next(firstKey, start) == 0 && firstKey <= maxKey) {
+        // the entries of equal keys are sorted by RecordId only within a leaf
+        while (first.next(k, r) == 0 && k == firstKey) {
+          if (r < start) start = r;
         }
+      } else {
+        start = rf.endRid();
+      }
+      seeked = true;
+      index.close();
+      goto no_index;
+    }
 
-        // check the conditions on the tuple
-        for (unsigned i = 0; i < cond.size(); i++) {
-          // compute the difference between the tuple value and the condition value
-          switch (cond[i].attr) {
-          case 1:
-            diff = searchKey - atoi(cond[i].value);
-            break;
-          case 2:
-            diff = strcmp(value.c_str(), cond[i].value);
-            break;
-          }
-          if (DEBUG)
-          {
-            cout << "i: " << i << endl;
-            cout << "seachKey: " << searchKey << endl;
-            cout << "cond[i].value: " << cond[i].value << endl;
-          }
-
-          // skip the search if any condition is not met
-          switch (cond[i].comp) {
-            case SelCond::EQ:
-              if (diff != 0) isEqual = false;
-              break;
-            case SelCond::NE:
-              if (diff == 0) isEqual = false;
-              break;
-            case SelCond::GT:
-              if (diff <= 0) isEqual = false;
-              break;
-            case SelCond::LT:
-              if (diff >= 0) isEqual = false;
-              break;
-            case SelCond::GE:
-              if (diff < 0) isEqual = false;
-              break;
-            case SelCond::LE:
-              if (diff > 0) isEqual = false;
-              break;
-          }
-          if (!isEqual)
-            break;
-        }
-        if (isEqual)
-        {
-          // the conditions are met for the tuple. 
-          // increase matching tuple counter
-          count++;
-
-          // print the tuple 
-          switch (attr) {
-          case 1:  // SELECT key
-            fprintf(stdout, "%d\n", searchKey);
-            break;
-          case 2:  // SELECT value
-            fprintf(stdout, "%s\n", value.c_str());
-            break;
-          case 3:  // SELECT *
-            fprintf(stdout, "%d '%s'\n", searchKey, value.c_str());
-            break;
-          }
-        }
+    BTreeIndexCursor cursor;
+    if ((rc = cursor.locate(index, searchKey)) < 0) {
+      fprintf(stderr, "Error: while reading the index of table %s\n", table.c_str());
+      index.close();
+      goto exit_select;
     }
-    else if (isOnlyCountStar)
+    if (DEBUG)
     {
-      RC errorMsg = index.getTotalKeyCount(count);
-      if (errorMsg != 0)
-        return errorMsg;
+      cout << "searchKey: " << searchKey << endl;
+    }
+
+    if (isOnlyCountStar)
+    {
+      if ((rc = index.getTotalKeyCount(count)) != 0) {
+        fprintf(stderr, "Error: while reading the index of table %s\n", table.c_str());
+        index.close();
+        goto exit_select;
+      }
     }
     else if (isReadVal)
     {
-      while (index.readForward(cursor, searchKey, rid) == 0 && searchKey <= maxKey)  {
+      while (cursor.next(searchKey, rid) == 0 && searchKey <= maxKey)  {
         bool skip = false;
         // read the tuple
         if ((rc = rf.read(rid, searchKey, value)) < 0) {
@@ -377,7 +536,14 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
     }
     else  // don't read values from PageFile unless we have a match
     {
-      while (index.readForward(cursor, searchKey, rid) == 0 && searchKey <= maxKey)  {
+      // the keys are read a leaf at a time, and only checked here
+      int      keys[BTLeafNode::MAX_LEAF_ENTRIES];
+      RecordId rids[BTLeafNode::MAX_LEAF_ENTRIES];
+      int      n = 0, i = 0;
+      while ((i < n || (i = 0, cursor.next(BTLeafNode::MAX_LEAF_ENTRIES, keys, rids, n) == 0))
+             && keys[i] <= maxKey)  {
+        searchKey = keys[i];
+        rid = rids[i++];
         bool skip = false;
         // check the conditions on the tuple
         for (unsigned i = 0; i < cond.size(); i++) {
@@ -416,8 +582,12 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
           // increase matching tuple counter
           count++;
 
-          // read the tuple
-          if ((rc = rf.read(rid, searchKey, value)) < 0) {
+          // read the tuple. the value is decoded only when it is printed
+          if (useDict && attr != 2 && attr != 3)
+            rc = rf.readCode(rid, searchKey, code);
+          else
+            rc = rf.read(rid, searchKey, value);
+          if (rc < 0) {
             fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
             goto exit_select;
           }
@@ -450,70 +620,592 @@ RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond)
 
   // close the table file and return
   exit_select:
+  if (useZoneMap)
+    zm.close();
+  if (useBloom)
+    bf.close();
   rf.close();
+  if (useDict)
+    dict.close();
   return rc;
 }
 
-RC SqlEngine::load(const string& table, const string& loadfile, bool index)
+RC SqlEngine::select(int attr, const string& table, const vector<SelCond>& cond, const SelOrder& order)
 {
-  RecordFile* recordFile = new RecordFile(table + ".tbl", 'w');
-  ifstream fileName(loadfile.c_str());
-  string line;
-  int key;
-  string value;
-  RecordId recordId;
+  RecordFile      rf;
+  ValueDictionary dict;
+  bool            useDict;
+  BTreeIndex      index;
+  IndexCursor     cursor;
+  RecordId        rid;
+  int             key, lo, hi;
+  string          value;
+  int             count = 0;
+  int             limit = (order.limit < 0) ? INT_MAX : order.limit;
+  RC              rc = 0;
 
-  if (index)
-  {
-    BTreeIndex btree;
-    btree.open(table + ".idx", 'w');
+  if (order.attr == 0 && order.limit < 0)
+    return select(attr, table, cond);
 
-    while (getline(fileName, line))
-    {
-      if (parseLoadLine(line, key, value) == 0)
-      {
-        if (recordFile->append(key, value, recordId) != 0)
-        {
-          return RC_INVALID_ATTRIBUTE;
-        }
-        if (btree.insert(key, recordId) != 0)
-        {
-          return RC_FILE_WRITE_FAILED;
-        }
-      }
+  // a table with an index is read in key order through the index. a
+  // descending read starts at the last key of the key range, at the right
+  // edge of the tree if there is no upper bound.
+  if (!TableWriter::isOrganized(table) && !TableWriter::isLSM(table) &&
+      !TableWriter::isFrozen(table) && index.open(table + ".idx", 'r') == 0) {
+    useDict = (dict.open(table + ".dict", 'r') == 0);
+    if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+      fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+      index.close();
+      if (useDict)
+        dict.close();
+      return rc;
+    }
+
+    // the tuple is only read when its value is needed
+    bool readValue = (attr == 2 || attr == 3);
+    for (unsigned i = 0; i < cond.size(); i++)
+      if (cond[i].attr == 2) readValue = true;
+
+    if (keyRange(cond, lo, hi)) {
+      BTreeIndexCursor forward;
+      if (order.descending)
+        rc = index.locateBackward(hi, cursor);
       else
-      {
-        return RC_INVALID_ATTRIBUTE;
+        rc = forward.locate(index, lo);
+      while (rc == 0 && count < limit) {
+        rc = order.descending ? index.readBackward(cursor, key, rid)
+                              : forward.next(key, rid);
+        if (rc != 0 || (order.descending ? key < lo : key > hi))
+          break;
+        if (readValue && (rc = rf.read(rid, key, value)) < 0)
+          break;
+        if (!tupleMatches(key, value, cond))
+          continue;
+        count++;
+        printTuple(attr, key, value);
       }
+      if (rc == RC_END_OF_TREE)
+        rc = 0;
+    }
+
+    rf.close();
+    index.close();
+    if (useDict)
+      dict.close();
+  } else {
+    // other tables are read in full and sorted by key.
+    // the tuples of the same key stay in the order they are stored.
+    vector<pair<int, string> > tuples;
+    if ((rc = readTable(table, tuples)) < 0)
+      return rc;
+    if (order.attr == 1) {
+      stable_sort(tuples.begin(), tuples.end(), compareKeys);
+      if (order.descending)
+        reverse(tuples.begin(), tuples.end());
+    }
+    for (unsigned i = 0; i < tuples.size() && count < limit; i++) {
+      if (!tupleMatches(tuples[i].first, tuples[i].second, cond))
+        continue;
+      count++;
+      printTuple(attr, tuples[i].first, tuples[i].second);
     }
-    
-    btree.close();
   }
-  else
-  {
-    while (getline(fileName, line))
-    {
-      if (parseLoadLine(line, key, value) == 0)
-      {
-        if (recordFile->append(key, value, recordId) == 0)
-        {
 
-        }
-        else
-        {
-          return RC_INVALID_ATTRIBUTE;
+  if (rc < 0)
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+  else if (attr == 4)
+    fprintf(stdout, "%d\n", count);
+
+  return rc;
+}
+
+RC SqlEngine::selectAny(int attr, const string& table, const vector<SelCond>& cond)
+{
+  RecordFile          rf;
+  ValueDictionary     dict;
+  bool                useDict;
+  BTreeIndex          index;
+  vector<int>         keys;
+  vector<IndexCursor> cursors;
+  set<int>            seen;
+  RecordId            rid;
+  int                 key;
+  string              value;
+  int                 count = 0;
+  RC                  rc = 0;
+
+  // a list of keys is looked up in the index in one walk down the tree
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].attr != 1 || cond[i].comp != SelCond::EQ) break;
+    keys.push_back(atoi(cond[i].value));
+  }
+
+  if (keys.size() == cond.size() && !TableWriter::isOrganized(table) &&
+      !TableWriter::isLSM(table) && !TableWriter::isFrozen(table) &&
+      index.open(table + ".idx", 'r') == 0) {
+    useDict = (dict.open(table + ".dict", 'r') == 0);
+    if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+      fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+      index.close();
+      if (useDict)
+        dict.close();
+      return rc;
+    }
+
+    cursors.resize(keys.size());
+    rc = index.locateMany(&keys[0], keys.size(), &cursors[0]);
+    for (unsigned i = 0; rc == 0 && i < keys.size(); i++) {
+      // a key listed twice selects its tuples once
+      if (!seen.insert(keys[i]).second)
+        continue;
+      while ((rc = index.readForward(cursors[i], key, rid)) == 0 && key == keys[i]) {
+        if ((attr == 2 || attr == 3) && (rc = rf.read(rid, key, value)) < 0)
+          break;
+        count++;
+        printTuple(attr, key, value);
+      }
+      if (rc == RC_END_OF_TREE)
+        rc = 0;
+    }
+
+    rf.close();
+    index.close();
+    if (useDict)
+      dict.close();
+  } else {
+    // other tables are read in full
+    vector<pair<int, string> > tuples;
+    if ((rc = readTable(table, tuples)) < 0)
+      return rc;
+    for (unsigned i = 0; i < tuples.size(); i++) {
+      for (unsigned j = 0; j < cond.size(); j++) {
+        if (tupleMatches(tuples[i].first, tuples[i].second, vector<SelCond>(1, cond[j]))) {
+          count++;
+          printTuple(attr, tuples[i].first, tuples[i].second);
+          break;
         }
       }
-      else
+    }
+  }
+
+  if (rc < 0)
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+  else if (attr == 4)
+    fprintf(stdout, "%d\n", count);
+
+  return rc;
+}
+
+RC SqlEngine::load(const string& table, const string& loadfile, int options)
+{
+  TableWriter writer;
+  ifstream    fileName(loadfile.c_str());
+  string      line;
+  int         key;
+  string      value;
+  int         tuples = 0;
+  RC          rc, parseRc = 0;
+  vector<pair<int, string> > sorted;  // the tuples of a clustered load
+
+  invalidateCache(table);
+
+  // a clustered load reads the whole file and appends the tuples in key
+  // order. tuples with the same key keep their order in the file.
+  if (options & LOAD_CLUSTERED) {
+    while (getline(fileName, line)) {
+      if (parseLoadLine(line, key, value) != 0) {
+        parseRc = RC_INVALID_ATTRIBUTE;
+        break;
+      }
+      sorted.push_back(make_pair(key, value));
+    }
+    stable_sort(sorted.begin(), sorted.end(), compareKeys);
+    tuples = sorted.size();
+  } else if (options & LOAD_BLOOM) {
+    // a new Bloom filter is sized for the tuples in the load file
+    ifstream countFile(loadfile.c_str());
+    while (getline(countFile, line)) tuples++;
+  }
+
+  if ((rc = writer.open(table, options, tuples)) < 0) {
+    if (rc == RC_INVALID_FILE_MODE)
+      fprintf(stderr, "Error: table %s is frozen\n", table.c_str());
+    else
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+    return rc;
+  }
+
+  if (options & LOAD_CLUSTERED) {
+    for (unsigned i = 0; i < sorted.size(); i++) {
+      if ((rc = writer.append(sorted[i].first, sorted[i].second)) < 0)
+        break;
+    }
+    if (rc == 0)
+      rc = parseRc;
+  } else {
+    while (getline(fileName, line))
+    {
+      if (parseLoadLine(line, key, value) != 0)
       {
-        return RC_INVALID_ATTRIBUTE;
+        rc = RC_INVALID_ATTRIBUTE;
+        break;
       }
+      if ((rc = writer.append(key, value)) < 0)
+        break;
     }
   }
 
   fileName.close();
-  recordFile->close();
-  delete(recordFile);
+  if (writer.close() < 0 && rc == 0)
+    rc = RC_FILE_WRITE_FAILED;
+
+  if (rc == 0 && (options & LOAD_FROZEN))
+    rc = freeze(table);
+
+  return rc;
+}
+
+RC SqlEngine::insert(const string& table, const vector<InsertTuple>& tuples)
+{
+  TableWriter writer;
+  RC          rc;
+
+  invalidateCache(table);
+
+  if ((rc = writer.open(table, 0, tuples.size())) < 0) {
+    if (rc == RC_INVALID_FILE_MODE)
+      fprintf(stderr, "Error: table %s is frozen\n", table.c_str());
+    else
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+    return rc;
+  }
+
+  for (unsigned i = 0; i < tuples.size(); i++) {
+    if ((rc = writer.append(tuples[i].key, tuples[i].value)) < 0) {
+      fprintf(stderr, "Error: cannot insert into table %s\n", table.c_str());
+      break;
+    }
+  }
+
+  if (writer.close() < 0 && rc == 0)
+    rc = RC_FILE_WRITE_FAILED;
+
+  return rc;
+}
+
+RC SqlEngine::deleteTuples(const string& table, const vector<SelCond>& cond)
+{
+  RecordFile       rf;
+  BTreeIndex       btree;
+  ValueDictionary  dict;
+  vector<int>      keys;
+  vector<RecordId> rids;
+  RC               rc;
+  bool             useDict, index;
+
+  invalidateCache(table);
+
+  if (TableWriter::isOrganized(table))
+    return modifyOrganized(table, cond, NULL);
+  if (TableWriter::isLSM(table))
+    return modifyLSM(table, cond, NULL);
+  if (TableWriter::isFrozen(table)) {
+    fprintf(stderr, "Error: table %s is frozen\n", table.c_str());
+    return RC_INVALID_FILE_MODE;
+  }
+
+  // find the tuples to delete first, so that we do not modify
+  // the index while we are reading it
+  useDict = (dict.open(table + ".dict", 'r') == 0);
+  if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+    fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+  index = (btree.open(table + ".idx", 'r') == 0);
+  rc = findTuples(rf, index ? &btree : NULL, cond, keys, rids);
+  if (index)
+    btree.close();
+  rf.close();
+  if (rc < 0) {
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+
+  // mark the tuples deleted and remove them from the index.
+  // the zone map and the Bloom filter still cover the deleted tuples,
+  // which only makes them less selective until the next VACUUM.
+  if ((rc = rf.open(table + ".tbl", 'w', useDict ? &dict : NULL)) < 0) {
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+  if (index && (rc = btree.open(table + ".idx", 'w')) < 0) {
+    rf.close();
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+  for (unsigned i = 0; i < rids.size(); i++) {
+    if ((rc = rf.remove(rids[i])) < 0)
+      break;
+    if (index && (rc = btree.remove(keys[i], rids[i])) < 0)
+      break;
+  }
+
+  if (index)
+    btree.close();
+  rf.close();
+  if (useDict)
+    dict.close();
+
+  return rc;
+}
+
+RC SqlEngine::updateTuples(const string& table, const string& value, const vector<SelCond>& cond)
+{
+  RecordFile       rf;
+  BTreeIndex       btree;
+  ZoneMap          zm;
+  BloomFilter      bf;
+  ValueDictionary  dict;
+  vector<int>      keys;
+  vector<RecordId> rids;
+  RC               rc;
+  bool             useDict, index, useZoneMap, useBloom;
+
+  invalidateCache(table);
+
+  if (TableWriter::isOrganized(table))
+    return modifyOrganized(table, cond, &value);
+  if (TableWriter::isLSM(table))
+    return modifyLSM(table, cond, &value);
+  if (TableWriter::isFrozen(table)) {
+    fprintf(stderr, "Error: table %s is frozen\n", table.c_str());
+    return RC_INVALID_FILE_MODE;
+  }
+
+  // find the tuples to update first
+  useDict = (dict.open(table + ".dict", 'r') == 0);
+  if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+    fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+  index = (btree.open(table + ".idx", 'r') == 0);
+  rc = findTuples(rf, index ? &btree : NULL, cond, keys, rids);
+  if (index)
+    btree.close();
+  rf.close();
+  if (useDict)
+    dict.close();
+  if (rc < 0) {
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+    return rc;
+  }
+  if (rids.empty())
+    return 0;
+
+  // the new value may be new to the dictionary
+  if (useDict && (rc = dict.open(table + ".dict", 'w')) < 0)
+    return rc;
+  if ((rc = rf.open(table + ".tbl", 'w', useDict ? &dict : NULL)) < 0) {
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+
+  // the zone map and the Bloom filter have to cover the new value.
+  // the old value stays in them, which is harmless.
+  useZoneMap = (zm.open(table + ".zm", 'r') == 0);
+  if (useZoneMap) {
+    zm.close();
+    useZoneMap = (zm.open(table + ".zm", 'w') == 0);
+  }
+  useBloom = (bf.open(table + ".bf", 'w') == 0);
+
+  for (unsigned i = 0; i < rids.size(); i++) {
+    if ((rc = rf.update(rids[i], value)) < 0)
+      break;
+    if (useZoneMap && (rc = zm.update(rids[i], keys[i], value)) < 0)
+      break;
+    if (useBloom && (rc = bf.add(rids[i], keys[i], value)) < 0)
+      break;
+  }
+
+  if (useBloom)
+    bf.close();
+  if (useZoneMap)
+    zm.close();
+  rf.close();
+  if (useDict)
+    dict.close();
+
+  return rc;
+}
+
+RC SqlEngine::vacuum(const string& table)
+{
+  RecordFile         rf;
+  BTreeIndex         btree;
+  ZoneMap            zm;
+  BloomFilter        bf;
+  ValueDictionary    dict;
+  vector<RecordMove> moves;
+  RecordId           rid;
+  int                key;
+  string             value;
+  int                tuples;
+  RC                 rc;
+  bool               useDict, index, useZoneMap, useBloom;
+
+  // an index-organized table removes its tuples in place and a frozen
+  // table has no deleted tuples, so there is nothing to reclaim
+  if (TableWriter::isOrganized(table) || TableWriter::isFrozen(table))
+    return 0;
+
+  // a log-structured table is vacuumed by merging its runs
+  if (TableWriter::isLSM(table)) {
+    LSMTable lsm;
+    if ((rc = lsm.open(table, 'w')) < 0) {
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+      return rc;
+    }
+    if ((rc = lsm.compact()) < 0)
+      fprintf(stderr, "Error: while compacting table %s\n", table.c_str());
+    RC closeRc = lsm.close();
+    return (rc < 0) ? rc : closeRc;
+  }
+
+  useDict = (dict.open(table + ".dict", 'r') == 0);
+  if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+    fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+  rf.close();
+
+  // move the live tuples to the front of the table
+  if ((rc = rf.open(table + ".tbl", 'w', useDict ? &dict : NULL)) < 0 ||
+      (rc = rf.compact(moves)) < 0) {
+    fprintf(stderr, "Error: while compacting table %s\n", table.c_str());
+    rf.close();
+    if (useDict)
+      dict.close();
+    return rc;
+  }
+
+  // patch the index entries of the moved tuples
+  index = (btree.open(table + ".idx", 'r') == 0);
+  if (index) {
+    btree.close();
+    if ((rc = btree.open(table + ".idx", 'w')) == 0) {
+      for (unsigned i = 0; i < moves.size(); i++) {
+        if ((rc = btree.replace(moves[i].key, moves[i].from, moves[i].to)) < 0)
+          break;
+      }
+      btree.close();
+    }
+  }
+
+  // the tuples are in other zones now, and the deleted ones are gone.
+  // rebuild the zone map and the Bloom filter if the table has them.
+  useZoneMap = (zm.open(table + ".zm", 'r') == 0);
+  if (useZoneMap) {
+    zm.close();
+    remove((table + ".zm").c_str());
+    useZoneMap = (rc == 0 && (rc = zm.open(table + ".zm", 'w')) == 0);
+  }
+  useBloom = (bf.open(table + ".bf", 'r') == 0);
+  if (useBloom) {
+    bf.close();
+    remove((table + ".bf").c_str());
+    tuples = rf.endRid().pid * rf.getRecordsPerPage() + rf.endRid().sid;
+    useBloom = (rc == 0 && (rc = bf.create(table + ".bf", tuples, rf.getRecordsPerPage())) == 0);
+  }
+  for (rid.pid = rid.sid = 0; rc == 0 && (useZoneMap || useBloom) && rid < rf.endRid(); rf.next(rid)) {
+    if ((rc = rf.read(rid, key, value)) < 0)
+      break;
+    if (useZoneMap && (rc = zm.update(rid, key, value)) < 0)
+      break;
+    if (useBloom && (rc = bf.add(rid, key, value)) < 0)
+      break;
+  }
+
+  if (useBloom)
+    bf.close();
+  if (useZoneMap)
+    zm.close();
+  rf.close();
+  if (useDict)
+    dict.close();
+
+  return rc;
+}
+
+RC SqlEngine::freeze(const string& table)
+{
+  vector<pair<int, string> > tuples;
+  SSTable          sst;
+  RC               rc;
+
+  if (TableWriter::isFrozen(table)) return 0;
+
+  if ((rc = readTable(table, tuples)) < 0) return rc;
+
+  // tuples with the same key keep their order in the table
+  stable_sort(tuples.begin(), tuples.end(), compareKeys);
+
+  if ((rc = sst.create(table + ".sst")) < 0) {
+    fprintf(stderr, "Error: cannot create table %s\n", table.c_str());
+    return rc;
+  }
+  for (unsigned i = 0; i < tuples.size(); i++) {
+    if ((rc = sst.append(tuples[i].first, tuples[i].second)) < 0) break;
+  }
+  if (rc < 0 || (rc = sst.close()) < 0) {
+    fprintf(stderr, "Error: while writing table %s\n", table.c_str());
+    sst.close();
+    remove((table + ".sst").c_str());
+    return rc;
+  }
+
+  // the SSTable replaces the table and all of its access structures
+  remove((table + ".tbl").c_str());
+  remove((table + ".iot").c_str());
+  remove((table + ".dict").c_str());
+  remove((table + ".idx").c_str());
+  remove((table + ".zm").c_str());
+  remove((table + ".bf").c_str());
+  remove((table + ".cl").c_str());
+  if (TableWriter::isLSM(table)) {
+    LSMTable lsm;
+    if (lsm.open(table, 'r') == 0)
+      lsm.drop();
+  }
+
+  return 0;
+}
+
+RC SqlEngine::cache(const string& table)
+{
+  vector<pair<int, string> > tuples;
+  RC rc;
+
+  staleTables.erase(table);
+  if ((rc = readTable(table, tuples)) < 0) {
+    cachedTables.erase(table);
+    return rc;
+  }
+
+  // tuples with the same key keep their order in the table
+  stable_sort(tuples.begin(), tuples.end(), compareKeys);
+  cachedTables[table].build(tuples);
 
   return 0;
 }
@@ -558,3 +1250,418 @@ RC SqlEngine::parseLoadLine(const string& line, int& key, string& value)
 
     return 0;
 }
+
+static bool zoneMayMatch(const ZoneMap::Zone& zone, const vector<SelCond>& cond)
+{
+  int lo, hi;   // how the smallest and the largest tuple compare to the condition
+  int v;
+
+  // an empty zone has no tuple to return
+  if (zone.count == 0) return false;
+
+  for (unsigned i = 0; i < cond.size(); i++) {
+    switch (cond[i].attr) {
+    case 1:
+      v = atoi(cond[i].value);
+      lo = (zone.minKey > v) - (zone.minKey < v);
+      hi = (zone.maxKey > v) - (zone.maxKey < v);
+      break;
+    case 2:
+      lo = strcmp(zone.minValue, cond[i].value);
+      hi = strcmp(zone.maxValue, cond[i].value);
+      break;
+    default:
+      continue;
+    }
+
+    // the zone can be skipped if the condition fails for the whole range
+    switch (cond[i].comp) {
+      case SelCond::EQ:
+        if (lo > 0 || hi < 0) return false;
+        break;
+      case SelCond::NE:
+        if (lo == 0 && hi == 0) return false;
+        break;
+      case SelCond::GT:
+        if (hi <= 0) return false;
+        break;
+      case SelCond::LT:
+        if (lo >= 0) return false;
+        break;
+      case SelCond::GE:
+        if (hi < 0) return false;
+        break;
+      case SelCond::LE:
+        if (lo > 0) return false;
+        break;
+    }
+  }
+
+  return true;
+}
+
+static bool bloomMayMatch(const BloomFilter& bf, int zid, const vector<SelCond>& cond)
+{
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].comp != SelCond::EQ) continue;
+
+    switch (cond[i].attr) {
+    case 1:
+      if (zid < 0 ? !bf.mayContainKey(atoi(cond[i].value))
+                  : !bf.zoneMayContainKey(zid, atoi(cond[i].value)))
+        return false;
+      break;
+    case 2:
+      if (zid < 0 ? !bf.mayContainValue(cond[i].value)
+                  : !bf.zoneMayContainValue(zid, cond[i].value))
+        return false;
+      break;
+    }
+  }
+
+  return true;
+}
+
+static bool keyRange(const vector<SelCond>& cond, int& lo, int& hi)
+{
+  long long l = INT_MIN, h = INT_MAX;
+
+  for (unsigned i = 0; i < cond.size(); i++) {
+    if (cond[i].attr != 1) continue;
+
+    long long v = atoi(cond[i].value);
+    switch (cond[i].comp) {
+      case SelCond::EQ:
+        if (v > l) l = v;
+        if (v < h) h = v;
+        break;
+      case SelCond::GT:
+        if (v + 1 > l) l = v + 1;
+        break;
+      case SelCond::GE:
+        if (v > l) l = v;
+        break;
+      case SelCond::LT:
+        if (v - 1 < h) h = v - 1;
+        break;
+      case SelCond::LE:
+        if (v < h) h = v;
+        break;
+      default:
+        break;
+    }
+  }
+  if (l > h) return false;
+
+  lo = (int) l;
+  hi = (int) h;
+  return true;
+}
+
+static bool compareKeys(const pair<int, string>& a, const pair<int, string>& b)
+{
+  return a.first < b.first;
+}
+
+static bool tupleMatches(int key, const string& value, const vector<SelCond>& cond)
+{
+  int diff;
+
+  for (unsigned i = 0; i < cond.size(); i++) {
+    // compute the difference between the tuple value and the condition value
+    switch (cond[i].attr) {
+    case 1:
+      diff = (key > atoi(cond[i].value)) - (key < atoi(cond[i].value));
+      break;
+    case 2:
+      diff = strcmp(value.c_str(), cond[i].value);
+      break;
+    default:
+      continue;
+    }
+
+    switch (cond[i].comp) {
+      case SelCond::EQ:
+        if (diff != 0) return false;
+        break;
+      case SelCond::NE:
+        if (diff == 0) return false;
+        break;
+      case SelCond::GT:
+        if (diff <= 0) return false;
+        break;
+      case SelCond::LT:
+        if (diff >= 0) return false;
+        break;
+      case SelCond::GE:
+        if (diff < 0) return false;
+        break;
+      case SelCond::LE:
+        if (diff > 0) return false;
+        break;
+    }
+  }
+
+  return true;
+}
+
+static RC findTuples(const RecordFile& rf, BTreeIndex* index, const vector<SelCond>& cond,
+                     vector<int>& keys, vector<RecordId>& rids)
+{
+  RC               rc;
+  RecordId         rid;
+  BTreeIndexCursor cursor;
+  int              key, lo, hi;
+  string           value;
+
+  keys.clear();
+  rids.clear();
+  if (!keyRange(cond, lo, hi)) return 0;
+
+  // with an index, only look at the tuples in the key range
+  if (index != NULL && (lo != INT_MIN || hi != INT_MAX)) {
+    if ((rc = cursor.locate(*index, lo)) < 0) return rc;
+    while (cursor.next(key, rid) == 0 && key <= hi) {
+      if (key < lo) continue;
+      if ((rc = rf.read(rid, key, value)) < 0) return rc;
+      if (tupleMatches(key, value, cond)) {
+        keys.push_back(key);
+        rids.push_back(rid);
+      }
+    }
+    return 0;
+  }
+
+  for (rid.pid = rid.sid = 0; rid < rf.endRid(); rf.next(rid)) {
+    if ((rc = rf.read(rid, key, value)) == RC_NO_SUCH_RECORD) continue;
+    if (rc < 0) return rc;
+    if (tupleMatches(key, value, cond)) {
+      keys.push_back(key);
+      rids.push_back(rid);
+    }
+  }
+
+  return 0;
+}
+
+// position a sorted table at the first key >= lo. only an LSMTable
+// uses hi, to skip the runs without keys in the range.
+template<class SortedTable>
+static RC locateRange(SortedTable& st, int lo, int /* hi */, typename SortedTable::Cursor& cursor)
+{
+  return st.locate(lo, cursor);
+}
+
+static RC locateRange(LSMTable& st, int lo, int hi, LSMTable::Cursor& cursor)
+{
+  return st.locate(lo, hi, cursor);
+}
+
+template<class SortedTable>
+static RC selectSorted(SortedTable& st, int attr, const string& table, const vector<SelCond>& cond)
+{
+  typename SortedTable::Cursor cursor;
+  int    key, lo, hi;
+  string value;
+  int    count = 0;
+  RC     rc = 0;
+
+  // the tuples are sorted by key, so we only read the pages
+  // of the key range. the table keeps the number of its tuples.
+  if (cond.size() == 0 && attr == 4) {
+    count = st.getTupleCount();
+  } else if (keyRange(cond, lo, hi)) {
+    locateRange(st, lo, hi, cursor);
+    while ((rc = st.readForward(cursor, key, value)) == 0 && key <= hi) {
+      if (!tupleMatches(key, value, cond)) continue;
+      count++;
+
+      // print the tuple
+      switch (attr) {
+      case 1:  // SELECT key
+        fprintf(stdout, "%d\n", key);
+        break;
+      case 2:  // SELECT value
+        fprintf(stdout, "%s\n", value.c_str());
+        break;
+      case 3:  // SELECT *
+        fprintf(stdout, "%d '%s'\n", key, value.c_str());
+        break;
+      }
+    }
+    if (rc == RC_END_OF_TREE)
+      rc = 0;
+  }
+
+  if (rc < 0)
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+  else if (attr == 4)
+    fprintf(stdout, "%d\n", count);
+
+  return rc;
+}
+
+static RC modifyOrganized(const string& table, const vector<SelCond>& cond, const string* value)
+{
+  BTreeTable          tree;
+  IndexCursor         cursor;
+  vector<IndexCursor> found;
+  int                 key, lo, hi;
+  string              v;
+  RC                  rc = 0;
+
+  if ((rc = tree.open(table + ".iot", 'w')) < 0) {
+    fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+    return rc;
+  }
+
+  // find the tuples first. readForward() leaves the cursor
+  // right behind the tuple it has read.
+  if (keyRange(cond, lo, hi)) {
+    tree.locate(lo, cursor);
+    while ((rc = tree.readForward(cursor, key, v)) == 0 && key <= hi) {
+      if (!tupleMatches(key, v, cond)) continue;
+      found.push_back(cursor);
+      found.back().eid--;
+    }
+    if (rc == RC_END_OF_TREE)
+      rc = 0;
+  }
+
+  // go from the back, so that removing a tuple does not
+  // move the tuples we have yet to remove
+  for (int i = (int) found.size() - 1; rc == 0 && i >= 0; i--)
+    rc = (value == NULL) ? tree.remove(found[i]) : tree.update(found[i], *value);
+
+  if (rc < 0)
+    fprintf(stderr, "Error: while modifying table %s\n", table.c_str());
+  RC closeRc = tree.close();
+  return (rc < 0) ? rc : closeRc;
+}
+
+static RC modifyLSM(const string& table, const vector<SelCond>& cond, const string* value)
+{
+  LSMTable         lsm;
+  LSMTable::Cursor cursor;
+  vector<pair<int, string> > tuples;
+  int              key, lo, hi;
+  string           v;
+  bool             changed = false;
+  RC               rc = 0;
+
+  if ((rc = lsm.open(table, 'w')) < 0) {
+    fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+    return rc;
+  }
+
+  // the runs are immutable, so the tuples are merged, modified
+  // in memory and written back as a single run
+  if (keyRange(cond, lo, hi)) {
+    lsm.locate(INT_MIN, INT_MAX, cursor);
+    while ((rc = lsm.readForward(cursor, key, v)) == 0) {
+      if (key >= lo && key <= hi && tupleMatches(key, v, cond)) {
+        changed = true;
+        if (value == NULL) continue;
+        v = *value;
+      }
+      tuples.push_back(make_pair(key, v));
+    }
+    if (rc == RC_END_OF_TREE)
+      rc = 0;
+  }
+  if (rc == 0 && changed)
+    rc = lsm.rewrite(tuples);
+
+  if (rc < 0)
+    fprintf(stderr, "Error: while modifying table %s\n", table.c_str());
+  RC closeRc = lsm.close();
+  return (rc < 0) ? rc : closeRc;
+}
+
+static void printTuple(int attr, int key, const string& value)
+{
+  switch (attr) {
+  case 1:  // SELECT key
+    fprintf(stdout, "%d\n", key);
+    break;
+  case 2:  // SELECT value
+    fprintf(stdout, "%s\n", value.c_str());
+    break;
+  case 3:  // SELECT *
+    fprintf(stdout, "%d '%s'\n", key, value.c_str());
+    break;
+  }
+}
+
+static void invalidateCache(const string& table)
+{
+  if (cachedTables.count(table) > 0)
+    staleTables.insert(table);
+}
+
+static RC readTable(const string& table, vector<pair<int, string> >& tuples)
+{
+  RC     rc;
+  int    key;
+  string value;
+
+  if (TableWriter::isOrganized(table)) {
+    BTreeTable  tree;
+    IndexCursor cursor;
+    if ((rc = tree.open(table + ".iot", 'r')) < 0) {
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+      return rc;
+    }
+    tree.locate(INT_MIN, cursor);
+    while ((rc = tree.readForward(cursor, key, value)) == 0)
+      tuples.push_back(make_pair(key, value));
+    tree.close();
+  } else if (TableWriter::isLSM(table)) {
+    LSMTable         lsm;
+    LSMTable::Cursor cursor;
+    if ((rc = lsm.open(table, 'r')) < 0) {
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+      return rc;
+    }
+    lsm.locate(INT_MIN, INT_MAX, cursor);
+    while ((rc = lsm.readForward(cursor, key, value)) == 0)
+      tuples.push_back(make_pair(key, value));
+    lsm.close();
+  } else if (TableWriter::isFrozen(table)) {
+    SSTable     sst;
+    IndexCursor cursor;
+    if ((rc = sst.open(table + ".sst")) < 0) {
+      fprintf(stderr, "Error: cannot open table %s\n", table.c_str());
+      return rc;
+    }
+    sst.locate(INT_MIN, cursor);
+    while ((rc = sst.readForward(cursor, key, value)) == 0)
+      tuples.push_back(make_pair(key, value));
+    sst.close();
+  } else {
+    RecordFile      rf;
+    ValueDictionary dict;
+    RecordId        rid;
+    bool            useDict = (dict.open(table + ".dict", 'r') == 0);
+    if ((rc = rf.open(table + ".tbl", 'r', useDict ? &dict : NULL)) < 0) {
+      fprintf(stderr, "Error: table %s does not exist\n", table.c_str());
+      if (useDict)
+        dict.close();
+      return rc;
+    }
+    for (rid.pid = rid.sid = 0; rid < rf.endRid(); rf.next(rid)) {
+      if ((rc = rf.read(rid, key, value)) == RC_NO_SUCH_RECORD) continue;
+      if (rc < 0) break;
+      tuples.push_back(make_pair(key, value));
+    }
+    rf.close();
+    if (useDict)
+      dict.close();
+  }
+  if (rc < 0 && rc != RC_END_OF_TREE && rc != RC_NO_SUCH_RECORD) {
+    fprintf(stderr, "Error: while reading a tuple from table %s\n", table.c_str());
+    return rc;
+  }
+
+  return 0;
+}
@@ -23,11 +23,41 @@ struct SelCond {
   char* value;  // the value to compare
 };
 
+/**
+ * data structure to represent the ORDER BY and LIMIT clauses of SELECT
+ */
+struct SelOrder {
+  int  attr;        // attribute to order by: 0 - none, 1 - key column, 2 - value column
+  bool descending;  // true for "ORDER BY ... DESC"
+  int  limit;       // the most tuples to return. -1 if there is no LIMIT
+};
+
+/**
+ * data structure to represent a tuple in the VALUES clause of INSERT
+ */
+struct InsertTuple {
+  int   key;    // the key column
+  char* value;  // the value column
+};
+
 /**
  * the class that takes, parses, and executes the user commands.
  */
 class SqlEngine {
  public:
+
+  /**
+   * options of the LOAD command. they can be combined with bitwise or.
+   */
+  enum LoadOption {
+    LOAD_INDEX      = 1,  // "WITH INDEX": build a B+tree index on the key
+    LOAD_BLOOM      = 2,  // "WITH BLOOM": build Bloom filters on key and value
+    LOAD_DICTIONARY = 4,  // "WITH DICTIONARY": store the values as dictionary codes
+    LOAD_CLUSTERED  = 8,  // "WITH CLUSTERED": store the tuples sorted by key
+    LOAD_ORGANIZED  = 16, // "WITH ORGANIZED": store the tuples in the B+tree leaves
+    LOAD_FROZEN     = 32, // "WITH FROZEN": freeze the table after the load
+    LOAD_LSM        = 64  // "WITH LSM": store the tuples in sorted runs
+  };
     
   /**
    * takes the user commands from commandline and executes them.
@@ -50,14 +80,99 @@ class SqlEngine {
    */
   static RC select(int attr, const std::string& table, const std::vector<SelCond>& conds);
 
+  /**
+   * executes a SELECT statement with ORDER BY key and/or LIMIT clauses.
+   * a table with an index is read through the index from the end of the
+   * key range the order starts at, e.g. from the right edge for
+   * "ORDER BY key DESC LIMIT n", and the read stops at the limit.
+   * other tables are read in full and sorted.
+   * @param attr[IN] attribute in the SELECT clause
+   * (1: key, 2: value, 3: *, 4: count(*))
+   * @param table[IN] the table name in the FROM clause
+   * @param conds[IN] list of conditions in the WHERE clause
+   * @param order[IN] the ORDER BY and LIMIT clauses
+   * @return error code. 0 if no error
+   */
+  static RC select(int attr, const std::string& table, const std::vector<SelCond>& conds, const SelOrder& order);
+
+  /**
+   * executes a SELECT statement whose conditions are joined by OR:
+   * a tuple is selected if it satisfies any of them. a list of
+   * "key = ..." conditions on a table with an index is looked up in the
+   * index all at once, and prints the tuples of each key in the order
+   * of the list. other tables are read in full.
+   * @param attr[IN] attribute in the SELECT clause
+   * (1: key, 2: value, 3: *, 4: count(*))
+   * @param table[IN] the table name in the FROM clause
+   * @param conds[IN] list of conditions in the WHERE clause
+   * @return error code. 0 if no error
+   */
+  static RC selectAny(int attr, const std::string& table, const std::vector<SelCond>& conds);
+
   /**
    * load a table from a load file.
    * @param table[IN] the table name in the LOAD command
    * @param loadfile[IN] the file name of the load file
-   * @param index[IN] true if "WITH INDEX" option was specified
+   * @param options[IN] the LoadOption flags given in the "WITH" clause
+   * @return error code. 0 if no error
+   */
+  static RC load(const std::string& table, const std::string& loadfile, int options);
+
+  /**
+   * insert tuples into a table, creating the table if it does not exist.
+   * the index, zone map, Bloom filter and dictionary of the table are
+   * updated as in load().
+   * @param table[IN] the table name in the INSERT command
+   * @param tuples[IN] list of tuples in the VALUES clause
+   * @return error code. 0 if no error
+   */
+  static RC insert(const std::string& table, const std::vector<InsertTuple>& tuples);
+
+  /**
+   * delete the tuples of a table that satisfy all conditions.
+   * the tuples are only marked deleted. vacuum() reclaims their space.
+   * @param table[IN] the table name in the DELETE command
+   * @param conds[IN] list of conditions in the WHERE clause
+   * @return error code. 0 if no error
+   */
+  static RC deleteTuples(const std::string& table, const std::vector<SelCond>& conds);
+
+  /**
+   * set the value of the tuples of a table that satisfy all conditions.
+   * the tuples are updated in place. their keys do not change,
+   * so the index is not modified.
+   * @param table[IN] the table name in the UPDATE command
+   * @param value[IN] the new value
+   * @param conds[IN] list of conditions in the WHERE clause
+   * @return error code. 0 if no error
+   */
+  static RC updateTuples(const std::string& table, const std::string& value, const std::vector<SelCond>& conds);
+
+  /**
+   * compact a table: move the live tuples into dense pages, shrink the
+   * table file, and update the index, zone map and Bloom filter.
+   * @param table[IN] the table name in the VACUUM command
+   * @return error code. 0 if no error
+   */
+  static RC vacuum(const std::string& table);
+
+  /**
+   * make a table immutable: write its tuples sorted by key into an
+   * SSTable and drop all other files of the table.
+   * a frozen table can be queried but not modified.
+   * @param table[IN] the table name in the FREEZE command
+   * @return error code. 0 if no error
+   */
+  static RC freeze(const std::string& table);
+
+  /**
+   * keep a copy of a table in memory, so that selects on the table are
+   * served without reading any page. writes to the table through the
+   * SqlEngine keep the copy up to date.
+   * @param table[IN] the table name in the CACHE TABLE command
    * @return error code. 0 if no error
    */
-  static RC load(const std::string& table, const std::string& loadfile, bool index);
+  static RC cache(const std::string& table);
 
   /**
    * parse a line from the load file into the (key, value) pair.
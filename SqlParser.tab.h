@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_SQL_SQLPARSER_TAB_H_INCLUDED
 # define YY_SQL_SQLPARSER_TAB_H_INCLUDED
 /* Debug traces.  */
@@ -40,50 +45,82 @@
 extern int sqldebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    SELECT = 258,
-    FROM = 259,
-    WHERE = 260,
-    LOAD = 261,
-    WITH = 262,
-    INDEX = 263,
-    QUIT = 264,
-    COUNT = 265,
-    AND = 266,
-    OR = 267,
-    COMMA = 268,
-    STAR = 269,
-    LF = 270,
-    INTEGER = 271,
-    STRING = 272,
-    ID = 273,
-    EQUAL = 274,
-    NEQUAL = 275,
-    LESS = 276,
-    LESSEQUAL = 277,
-    GREATER = 278,
-    GREATEREQUAL = 279
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    SELECT = 258,                  /* SELECT  */
+    FROM = 259,                    /* FROM  */
+    WHERE = 260,                   /* WHERE  */
+    LOAD = 261,                    /* LOAD  */
+    INSERT = 262,                  /* INSERT  */
+    INTO = 263,                    /* INTO  */
+    VALUES = 264,                  /* VALUES  */
+    DELETE = 265,                  /* DELETE  */
+    UPDATE = 266,                  /* UPDATE  */
+    SET = 267,                     /* SET  */
+    VACUUM = 268,                  /* VACUUM  */
+    FREEZE = 269,                  /* FREEZE  */
+    CACHE = 270,                   /* CACHE  */
+    TABLE = 271,                   /* TABLE  */
+    WITH = 272,                    /* WITH  */
+    INDEX = 273,                   /* INDEX  */
+    BLOOM = 274,                   /* BLOOM  */
+    DICTIONARY = 275,              /* DICTIONARY  */
+    CLUSTERED = 276,               /* CLUSTERED  */
+    ORGANIZED = 277,               /* ORGANIZED  */
+    FROZEN = 278,                  /* FROZEN  */
+    LSM = 279,                     /* LSM  */
+    ORDER = 280,                   /* ORDER  */
+    BY = 281,                      /* BY  */
+    ASC = 282,                     /* ASC  */
+    DESC = 283,                    /* DESC  */
+    LIMIT = 284,                   /* LIMIT  */
+    QUIT = 285,                    /* QUIT  */
+    COUNT = 286,                   /* COUNT  */
+    AND = 287,                     /* AND  */
+    OR = 288,                      /* OR  */
+    COMMA = 289,                   /* COMMA  */
+    STAR = 290,                    /* STAR  */
+    LPAREN = 291,                  /* LPAREN  */
+    RPAREN = 292,                  /* RPAREN  */
+    LF = 293,                      /* LF  */
+    INTEGER = 294,                 /* INTEGER  */
+    STRING = 295,                  /* STRING  */
+    ID = 296,                      /* ID  */
+    EQUAL = 297,                   /* EQUAL  */
+    NEQUAL = 298,                  /* NEQUAL  */
+    LESS = 299,                    /* LESS  */
+    LESSEQUAL = 300,               /* LESSEQUAL  */
+    GREATER = 301,                 /* GREATER  */
+    GREATEREQUAL = 302             /* GREATEREQUAL  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE YYSTYPE;
 union YYSTYPE
 {
-#line 33 "SqlParser.y" /* yacc.c:1909  */
+#line 39 "SqlParser.y"
 
   int integer;
   char* string;
   SelCond* cond;
   std::vector<SelCond>* conds;
+  InsertTuple* tuple;
+  std::vector<InsertTuple>* tuples;
+  SelOrder* order;
+
+#line 121 "SqlParser.tab.h"
 
-#line 86 "SqlParser.tab.h" /* yacc.c:1909  */
 };
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
 #endif
@@ -91,6 +128,8 @@ union YYSTYPE
 
 extern YYSTYPE sqllval;
 
+
 int sqlparse (void);
 
+
 #endif /* !YY_SQL_SQLPARSER_TAB_H_INCLUDED  */
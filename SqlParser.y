@@ -1,6 +1,7 @@
 %{
 #include <cstdio>
 #include <cstring>
+#include <cstdlib>
 #include <sys/times.h>
 #include <unistd.h>
 #include <climits>
@@ -13,7 +14,9 @@ int  sqllex(void);
 void sqlerror(const char *str) { fprintf(stderr, "Error: %s\n", str); }
 extern "C" { int  sqlwrap() { return 1; } }
 
-static void runSelect(int attr, const char* table, const std::vector<SelCond>& conds)
+// run a SELECT and print its time and page reads. with any, a tuple is
+// selected when it satisfies any of the conditions (joined by OR)
+static void runSelect(int attr, const char* table, const std::vector<SelCond>& conds, const SelOrder& order, bool any = false)
 {
   struct tms tmsbuf;
   clock_t btime, etime;
@@ -21,7 +24,10 @@ static void runSelect(int attr, const char* table, const std::vector<SelCond>& c
 
   btime = times(&tmsbuf);
   bpagecnt = PageFile::getPageReadCount();
-  SqlEngine::select(attr, table, conds);
+  if (any)
+    SqlEngine::selectAny(attr, table, conds);
+  else
+    SqlEngine::select(attr, table, conds, order);
   etime = times(&tmsbuf);
   epagecnt = PageFile::getPageReadCount();
 
@@ -35,17 +41,23 @@ static void runSelect(int attr, const char* table, const std::vector<SelCond>& c
   char* string;
   SelCond* cond;
   std::vector<SelCond>* conds;
+  InsertTuple* tuple;
+  std::vector<InsertTuple>* tuples;
+  SelOrder* order;
 }
 
-%token SELECT FROM WHERE LOAD WITH INDEX QUIT COUNT AND OR 
-%token COMMA STAR LF
+%token SELECT FROM WHERE LOAD INSERT INTO VALUES DELETE UPDATE SET VACUUM FREEZE CACHE TABLE WITH INDEX BLOOM DICTIONARY CLUSTERED ORGANIZED FROZEN LSM ORDER BY ASC DESC LIMIT QUIT COUNT AND OR 
+%token COMMA STAR LPAREN RPAREN LF
 %token <string> INTEGER STRING ID
 %token EQUAL NEQUAL LESS LESSEQUAL GREATER GREATEREQUAL 
 
-%type <integer> attributes attribute comparator
+%type <integer> attributes attribute comparator load_options load_option_list load_option direction limit
+%type <order> order
 %type <string> table value
 %type <cond> condition
-%type <conds> conditions
+%type <conds> conditions alternatives
+%type <tuple> tuple
+%type <tuples> tuples
 %%
 
 commands:
@@ -56,6 +68,12 @@ commands:
 command:
         load_command { fprintf(stdout, "Bruinbase> "); }
 	| select_command { fprintf(stdout, "Bruinbase> "); }
+	| insert_command { fprintf(stdout, "Bruinbase> "); }
+	| delete_command { fprintf(stdout, "Bruinbase> "); }
+	| update_command { fprintf(stdout, "Bruinbase> "); }
+	| vacuum_command { fprintf(stdout, "Bruinbase> "); }
+	| freeze_command { fprintf(stdout, "Bruinbase> "); }
+	| cache_command { fprintf(stdout, "Bruinbase> "); }
 	| quit_command
 	| error LF { fprintf(stdout, "Bruinbase> "); }
 	| LF { fprintf(stdout, "Bruinbase> "); }
@@ -66,31 +84,182 @@ quit_command:
 	;
 
 load_command:
-	LOAD table FROM STRING LF { 
-	  SqlEngine::load(std::string($2), std::string($4), false); 
-	  free($2);
-	  free($4);
-	}
-	| LOAD table FROM STRING WITH INDEX LF { 
-	  SqlEngine::load(std::string($2), std::string($4), true); 
+	LOAD table FROM STRING load_options LF { 
+	  SqlEngine::load(std::string($2), std::string($4), $5); 
 	  free($2);
 	  free($4);
 	}
 	;
 
+load_options:
+	/* no option */ { $$ = 0; }
+	| WITH load_option_list { $$ = $2; }
+	;
+
+load_option_list:
+	load_option { $$ = $1; }
+	| load_option_list COMMA load_option { $$ = $1 | $3; }
+	;
+
+load_option:
+	INDEX   { $$ = SqlEngine::LOAD_INDEX; }
+	| BLOOM { $$ = SqlEngine::LOAD_BLOOM; }
+	| DICTIONARY { $$ = SqlEngine::LOAD_DICTIONARY; }
+	| CLUSTERED { $$ = SqlEngine::LOAD_CLUSTERED; }
+	| ORGANIZED { $$ = SqlEngine::LOAD_ORGANIZED; }
+	| FROZEN { $$ = SqlEngine::LOAD_FROZEN; }
+	| LSM { $$ = SqlEngine::LOAD_LSM; }
+	;
+
 select_command:
-	SELECT attributes FROM table LF {
+	SELECT attributes FROM table order LF {
    	        std::vector<SelCond> conds;
-		runSelect($2, $4, conds);
+		if ($5->attr == 2) sqlerror("only the key column can be ordered by");
+		else runSelect($2, $4, conds, *$5);
 		free($4);
+		delete $5;
 	}
-	| SELECT attributes FROM table WHERE conditions LF {
-	        runSelect($2, $4, *$6);
+	| SELECT attributes FROM table WHERE conditions order LF {
+		if ($7->attr == 2) sqlerror("only the key column can be ordered by");
+		else runSelect($2, $4, *$6, *$7);
 	  	free($4);
 	  	for (unsigned i = 0; i < $6->size(); i++) {
 		    free((*$6)[i].value);
 		}
 	  	delete $6;
+		delete $7;
+	}
+	| SELECT attributes FROM table WHERE alternatives LF {
+		SelOrder none;
+		none.attr = 0;
+		none.descending = false;
+		none.limit = -1;
+		runSelect($2, $4, *$6, none, true);
+	  	free($4);
+	  	for (unsigned i = 0; i < $6->size(); i++) {
+		    free((*$6)[i].value);
+		}
+	  	delete $6;
+	}
+	;
+
+order:
+	limit {
+	  SelOrder* o = new SelOrder;
+	  o->attr = 0;
+	  o->descending = false;
+	  o->limit = $1;
+	  $$ = o;
+	}
+	| ORDER BY attribute direction limit {
+	  SelOrder* o = new SelOrder;
+	  o->attr = $3;
+	  o->descending = $4;
+	  o->limit = $5;
+	  $$ = o;
+	}
+	;
+
+direction:
+	/* ascending */ { $$ = 0; }
+	| ASC  { $$ = 0; }
+	| DESC { $$ = 1; }
+	;
+
+limit:
+	/* no limit */ { $$ = -1; }
+	| LIMIT INTEGER { $$ = atoi($2); free($2); }
+	;
+
+insert_command:
+	INSERT INTO table VALUES tuples LF {
+		SqlEngine::insert($3, *$5);
+		free($3);
+		for (unsigned i = 0; i < $5->size(); i++) {
+		    free((*$5)[i].value);
+		}
+		delete $5;
+	}
+	;
+
+tuples:
+	tuple {
+	  std::vector<InsertTuple>* v = new std::vector<InsertTuple>;
+	  v->push_back(*$1);
+	  $$ = v;
+	  delete $1;
+	}
+	| tuples COMMA tuple {
+	  $1->push_back(*$3);
+	  $$ = $1;
+	  delete $3;
+	}
+	;
+
+tuple:
+	LPAREN INTEGER COMMA value RPAREN {
+	  InsertTuple* t = new InsertTuple;
+	  t->key = atoi($2);
+	  t->value = $4;
+	  $$ = t;
+	  free($2);
+	}
+	;
+
+delete_command:
+	DELETE FROM table LF {
+		std::vector<SelCond> conds;
+		SqlEngine::deleteTuples($3, conds);
+		free($3);
+	}
+	| DELETE FROM table WHERE conditions LF {
+		SqlEngine::deleteTuples($3, *$5);
+		free($3);
+		for (unsigned i = 0; i < $5->size(); i++) {
+		    free((*$5)[i].value);
+		}
+		delete $5;
+	}
+	;
+
+update_command:
+	UPDATE table SET attribute EQUAL value LF {
+		std::vector<SelCond> conds;
+		if ($4 != 2) sqlerror("only the value column can be updated");
+		else SqlEngine::updateTuples($2, $6, conds);
+		free($2);
+		free($6);
+	}
+	| UPDATE table SET attribute EQUAL value WHERE conditions LF {
+		if ($4 != 2) sqlerror("only the value column can be updated");
+		else SqlEngine::updateTuples($2, $6, *$8);
+		free($2);
+		free($6);
+		for (unsigned i = 0; i < $8->size(); i++) {
+		    free((*$8)[i].value);
+		}
+		delete $8;
+	}
+	;
+
+vacuum_command:
+	VACUUM table LF {
+		SqlEngine::vacuum($2);
+		free($2);
+	}
+	;
+
+freeze_command:
+	FREEZE table LF {
+		SqlEngine::freeze($2);
+		free($2);
+	}
+	;
+
+cache_command:
+	CACHE TABLE table LF {
+		SqlEngine::cache($3);
+		free($3);
 	}
 	;
 
@@ -108,6 +277,22 @@ conditions:
 	}
 	;
 
+alternatives:
+	condition OR condition {
+	  std::vector<SelCond>* v = new std::vector<SelCond>;
+	  v->push_back(*$1);
+	  v->push_back(*$3);
+	  $$ = v;
+	  delete $1;
+	  delete $3;
+	}
+	| alternatives OR condition {
+	  $1->push_back(*$3);
+	  $$ = $1;
+	  delete $3;
+	}
+	;
+
 condition:
 	attribute comparator value { 
 	  SelCond* c = new SelCond;
@@ -0,0 +1,350 @@
+/**
+ * TableWriter: appends tuples to a table and keeps all of its access
+ * structures up to date.
+ */
+
+#include <cstdio>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include "Bruinbase.h"
+#include "SqlEngine.h"
+#include "TableWriter.h"
+
+using std::string;
+
+// add all tuples of a table to a Bloom filter
+static RC addToBloomFilter(const RecordFile& rf, BloomFilter& bf);
+
+// collect the index entries of all tuples of a table
+static RC addToIndex(const RecordFile& rf, std::vector<std::pair<int, RecordId> >& entries);
+
+// order index entries by key
+static bool compareEntries(const std::pair<int, RecordId>& a, const std::pair<int, RecordId>& b);
+
+// sort the entries of a new index and bulk load them into the index
+static RC buildIndex(std::vector<std::pair<int, RecordId> >& entries, BTreeIndex& btree);
+
+TableWriter::TableWriter()
+{
+  isOpen = false;
+  organized = logStructured = false;
+  useIndex = useZoneMap = useBloom = useDict = false;
+  newIndex = false;
+  clustered = clusterDirty = false;
+  lastKey = INT_MIN;
+}
+
+RC TableWriter::open(const string& table, int options, int newTuples)
+{
+  RC   rc;
+  bool newTable;
+
+  if (isOpen) return RC_FILE_OPEN_FAILED;
+  if (isFrozen(table)) return RC_INVALID_FILE_MODE;
+
+  // an index-organized or log-structured table is stored in a BTreeTable
+  // or in sorted runs instead of a table file. like the dictionary, this is
+  // decided when the table is created.
+  organized = isOrganized(table);
+  logStructured = !organized && isLSM(table);
+  if (!organized && !logStructured &&
+      (options & (SqlEngine::LOAD_ORGANIZED | SqlEngine::LOAD_LSM))) {
+    PageFile pf;
+    bool     empty = (pf.open(table + ".tbl", 'r') < 0);
+    if (!empty) {
+      empty = (pf.endPid() == 0);
+      pf.close();
+    }
+    if (empty) {
+      organized = (options & SqlEngine::LOAD_ORGANIZED) != 0;
+      logStructured = !organized;
+      remove((table + ".tbl").c_str());
+      remove((table + ".dict").c_str());
+      remove((table + ".idx").c_str());
+      remove((table + ".zm").c_str());
+      remove((table + ".bf").c_str());
+      remove((table + ".cl").c_str());
+    }
+  }
+  if (organized) {
+    if ((rc = tree.open(table + ".iot", 'w')) < 0) return rc;
+    isOpen = true;
+    return 0;
+  }
+  if (logStructured) {
+    if ((rc = lsm.open(table, 'w')) < 0) return rc;
+    isOpen = true;
+    return 0;
+  }
+
+  if ((rc = rf.open(table + ".tbl", 'w')) < 0) return rc;
+  newTable = (rf.endRid().pid == 0 && rf.endRid().sid == 0);
+
+  // whether the values are stored as dictionary codes is decided when the
+  // table is created. later loads keep the format of the table.
+  if (newTable) {
+    remove((table + ".dict").c_str());
+    useDict = (options & SqlEngine::LOAD_DICTIONARY) != 0;
+    rc = useDict ? dict.create(table + ".dict") : 0;
+  } else {
+    useDict = (dict.open(table + ".dict", 'w') == 0);
+    rc = 0;
+  }
+  if (useDict) {
+    rf.close();
+    if (rc < 0 || (rc = rf.open(table + ".tbl", 'w', &dict)) < 0) {
+      dict.close();
+      return rc;
+    }
+  }
+
+  // the zone map has to summarize every page of the table. so we build it
+  // only for a new table (dropping the one left over by an old table of the
+  // same name) or for a table that has been loaded with a zone map before.
+  if (newTable) {
+    remove((table + ".idx").c_str());
+    remove((table + ".zm").c_str());
+    remove((table + ".bf").c_str());
+    remove((table + ".cl").c_str());
+    useZoneMap = true;
+  } else {
+    useZoneMap = (zm.open(table + ".zm", 'r') == 0);
+    if (useZoneMap)
+      zm.close();
+  }
+  if (useZoneMap && (rc = zm.open(table + ".zm", 'w')) < 0) {
+    useZoneMap = false;
+    goto fail;
+  }
+
+  // the same goes for the Bloom filter: once a table has one, every new
+  // tuple has to be added to it. when asked for a filter that does not
+  // exist yet or is too small for the table, we build a new one sized
+  // for the table after the append.
+  useBloom = (bf.open(table + ".bf", 'w') == 0);
+  if (options & SqlEngine::LOAD_BLOOM) {
+    const RecordId& end = rf.endRid();
+    int tuples = end.pid * rf.getRecordsPerPage() + end.sid + newTuples;
+
+    if (!useBloom || bf.getCapacity() < tuples) {
+      if (useBloom)
+        bf.close();
+      useBloom = true;
+      if ((rc = bf.create(table + ".bf", tuples, rf.getRecordsPerPage())) < 0 ||
+          (rc = addToBloomFilter(rf, bf)) < 0) {
+        goto fail;
+      }
+    }
+  }
+
+  // an existing index has to cover the new tuples as well.
+  // a new index on an existing table starts with the tuples already there,
+  // and is built at close() when all entries are known.
+  useIndex = (btree.open(table + ".idx", 'r') == 0);
+  if (useIndex) {
+    btree.close();
+    if ((rc = btree.open(table + ".idx", 'w')) < 0) {
+      useIndex = false;
+      goto fail;
+    }
+  } else if (options & SqlEngine::LOAD_INDEX) {
+    useIndex = newIndex = true;
+    indexEntries.clear();
+    if ((rc = btree.open(table + ".idx", 'w')) < 0) {
+      useIndex = newIndex = false;
+      goto fail;
+    }
+    if ((rc = addToIndex(rf, indexEntries)) < 0) goto fail;
+  }
+
+  // a new table loaded in key order is clustered. an existing table
+  // stays clustered as long as the new keys do not go below its last key.
+  clusterFile = table + ".cl";
+  if (newTable) {
+    clustered = clusterDirty = (options & SqlEngine::LOAD_CLUSTERED) != 0;
+    lastKey = INT_MIN;
+  } else {
+    PageFile pf;
+    char     page[PageFile::PAGE_SIZE];
+    clustered = (pf.open(clusterFile, 'r') == 0);
+    if (clustered) {
+      clustered = (pf.read(0, page) == 0);
+      memcpy(&lastKey, page, sizeof(int));
+      pf.close();
+    }
+    clusterDirty = false;
+  }
+
+  isOpen = true;
+  return 0;
+
+  fail:
+  isOpen = true;
+  close();
+  return rc;
+}
+
+RC TableWriter::append(int key, const string& value)
+{
+  RecordId rid;
+
+  if (!isOpen) return RC_FILE_WRITE_FAILED;
+  if (organized) return tree.insert(key, value);
+  if (logStructured) return lsm.insert(key, value);
+
+  if (rf.append(key, value, rid) != 0) return RC_INVALID_ATTRIBUTE;
+  if (newIndex)
+    indexEntries.push_back(std::make_pair(key, rid));
+  else if (useIndex && btree.insert(key, rid) != 0)
+    return RC_FILE_WRITE_FAILED;
+  if (useZoneMap && zm.update(rid, key, value) != 0) return RC_FILE_WRITE_FAILED;
+  if (useBloom && bf.add(rid, key, value) != 0) return RC_FILE_WRITE_FAILED;
+
+  if (clustered) {
+    if (key < lastKey) {
+      clustered = false;
+      remove(clusterFile.c_str());
+    } else if (key > lastKey) {
+      lastKey = key;
+      clusterDirty = true;
+    }
+  }
+
+  return 0;
+}
+
+RC TableWriter::close()
+{
+  RC rc = 0, rc2;
+
+  if (!isOpen) return RC_FILE_CLOSE_FAILED;
+  if (organized) {
+    isOpen = organized = false;
+    return tree.close();
+  }
+  if (logStructured) {
+    isOpen = logStructured = false;
+    return lsm.close();
+  }
+
+  if (newIndex && (rc2 = buildIndex(indexEntries, btree)) < 0) rc = rc2;
+  if (useIndex && (rc2 = btree.close()) < 0) rc = rc2;
+  if (useZoneMap && (rc2 = zm.close()) < 0) rc = rc2;
+  if (useBloom && (rc2 = bf.close()) < 0) rc = rc2;
+  if ((rc2 = rf.close()) < 0) rc = rc2;
+  if (useDict && (rc2 = dict.close()) < 0) rc = rc2;
+
+  if (clustered && clusterDirty) {
+    PageFile pf;
+    char     page[PageFile::PAGE_SIZE];
+    memset(page, 0, PageFile::PAGE_SIZE);
+    memcpy(page, &lastKey, sizeof(int));
+    if ((rc2 = pf.open(clusterFile, 'w')) < 0 ||
+        (rc2 = pf.write(0, page)) < 0 || (rc2 = pf.close()) < 0) {
+      remove(clusterFile.c_str());
+      rc = rc2;
+    }
+  }
+
+  isOpen = false;
+  clustered = clusterDirty = false;
+  useIndex = useZoneMap = useBloom = useDict = false;
+  newIndex = false;
+
+  return rc;
+}
+
+bool TableWriter::isClustered(const string& table)
+{
+  PageFile pf;
+
+  if (pf.open(table + ".cl", 'r') < 0) return false;
+  pf.close();
+
+  return true;
+}
+
+bool TableWriter::isOrganized(const string& table)
+{
+  PageFile pf;
+
+  if (pf.open(table + ".iot", 'r') < 0) return false;
+  pf.close();
+
+  return true;
+}
+
+bool TableWriter::isLSM(const string& table)
+{
+  PageFile pf;
+
+  if (pf.open(table + ".lsm", 'r') < 0) return false;
+  pf.close();
+
+  return true;
+}
+
+bool TableWriter::isFrozen(const string& table)
+{
+  PageFile pf;
+
+  if (pf.open(table + ".sst", 'r') < 0) return false;
+  pf.close();
+
+  return true;
+}
+
+static RC addToBloomFilter(const RecordFile& rf, BloomFilter& bf)
+{
+  RC       rc;
+  RecordId rid;
+  int      key;
+  string   value;
+
+  for (rid.pid = rid.sid = 0; rid < rf.endRid(); rf.next(rid)) {
+    if ((rc = rf.read(rid, key, value)) == RC_NO_SUCH_RECORD) continue;
+    if (rc < 0) return rc;
+    if ((rc = bf.add(rid, key, value)) < 0) return rc;
+  }
+
+  return 0;
+}
+
+static RC addToIndex(const RecordFile& rf, std::vector<std::pair<int, RecordId> >& entries)
+{
+  RC       rc;
+  RecordId rid;
+  int      key;
+  string   value;
+
+  for (rid.pid = rid.sid = 0; rid < rf.endRid(); rf.next(rid)) {
+    if ((rc = rf.read(rid, key, value)) == RC_NO_SUCH_RECORD) continue;
+    if (rc < 0) return rc;
+    entries.push_back(std::make_pair(key, rid));
+  }
+
+  return 0;
+}
+
+static RC buildIndex(std::vector<std::pair<int, RecordId> >& entries, BTreeIndex& btree)
+{
+  std::vector<int>      keys(entries.size());
+  std::vector<RecordId> rids(entries.size());
+
+  // the tuples come in the order of their RecordIds, so a stable sort
+  // keeps the entries of the same key sorted as a leaf node needs them
+  std::stable_sort(entries.begin(), entries.end(), compareEntries);
+  for (unsigned i = 0; i < entries.size(); i++) {
+    keys[i] = entries[i].first;
+    rids[i] = entries[i].second;
+  }
+  entries.clear();
+
+  return btree.bulkLoad(keys.data(), rids.data(), keys.size());
+}
+
+static bool compareEntries(const std::pair<int, RecordId>& a, const std::pair<int, RecordId>& b)
+{
+  return a.first < b.first;
+}
@@ -0,0 +1,126 @@
+/**
+ * TableWriter: appends tuples to a table and keeps all of its access
+ * structures (index, zone map, Bloom filter and dictionary) up to date.
+ *
+ * LOAD and INSERT both add tuples at the end of a table. The writer opens
+ * every structure the table has once, so a batch of tuples only pays for
+ * opening the files once, and the pages they modify stay in the PageFile
+ * cache until the writer is closed.
+ *
+ * A new index is not built by inserting the tuples one by one: the writer
+ * collects the index entries, and close() sorts them and bulk loads the
+ * B+tree bottom up.
+ *
+ * A table loaded WITH CLUSTERED stores its tuples in key order. The writer
+ * remembers the largest key of such a table in a small sidecar file, and
+ * drops the file as soon as a tuple is appended out of order.
+ *
+ * A table loaded WITH ORGANIZED is index-organized: its tuples live in a
+ * BTreeTable (the .iot file) and it has none of the other files.
+ * A table loaded WITH LSM keeps its tuples in an LSMTable (the .lsm
+ * manifest and its runs) and has no other files either.
+ * A frozen table (the .sst file, see SqlEngine::freeze()) cannot be
+ * written at all.
+ */
+
+#ifndef TABLEWRITER_H
+#define TABLEWRITER_H
+
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "RecordFile.h"
+#include "BTreeIndex.h"
+#include "ZoneMap.h"
+#include "BloomFilter.h"
+#include "ValueDictionary.h"
+#include "BTreeTable.h"
+#include "LSMTable.h"
+
+class TableWriter {
+ public:
+
+  TableWriter();
+
+  /**
+   * open a table for appending tuples. the table is created if it
+   * does not exist.
+   * @param table[IN] the table name
+   * @param options[IN] the SqlEngine::LoadOption flags to build structures
+   * that the table does not have yet
+   * @param newTuples[IN] the number of tuples to be appended,
+   * used to size a new Bloom filter
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& table, int options, int newTuples);
+
+  /**
+   * append a tuple to the table.
+   * @param key[IN] the key of the tuple
+   * @param value[IN] the value of the tuple
+   * @return error code. 0 if no error
+   */
+  RC append(int key, const std::string& value);
+
+  /**
+   * write the changes to the disk and close all files of the table.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * check whether the tuples of a table are stored in key order.
+   * @param table[IN] the table name
+   * @return true if the table is clustered on the key
+   */
+  static bool isClustered(const std::string& table);
+
+  /**
+   * check whether a table is index-organized.
+   * @param table[IN] the table name
+   * @return true if the tuples of the table are stored in a BTreeTable
+   */
+  static bool isOrganized(const std::string& table);
+
+  /**
+   * check whether a table is log-structured.
+   * @param table[IN] the table name
+   * @return true if the tuples of the table are stored in an LSMTable
+   */
+  static bool isLSM(const std::string& table);
+
+  /**
+   * check whether a table is frozen.
+   * @param table[IN] the table name
+   * @return true if the tuples of the table are stored in an SSTable
+   */
+  static bool isFrozen(const std::string& table);
+
+ private:
+  RecordFile      rf;      // the table file
+  BTreeIndex      btree;   // the index of the table
+  ZoneMap         zm;      // the zone map of the table
+  BloomFilter     bf;      // the Bloom filter of the table
+  ValueDictionary dict;    // the value dictionary of the table
+  BTreeTable      tree;    // the tuples of an index-organized table
+  LSMTable        lsm;     // the tuples of a log-structured table
+
+  bool isOpen;             // true if the table is open
+  bool organized;          // true if the table is index-organized
+  bool logStructured;      // true if the table is log-structured
+  bool useIndex;           // true if the table has each of the structures
+  bool useZoneMap;
+  bool useBloom;
+  bool useDict;
+  bool newIndex;           // true if the index is bulk loaded at close()
+
+  // the entries of a new index, in the order of the tuples
+  std::vector<std::pair<int, RecordId> > indexEntries;
+
+  std::string clusterFile; // the file that marks the table as clustered
+  bool clustered;          // true if the tuples are in key order
+  bool clusterDirty;       // true if lastKey has changed since open()
+  int  lastKey;            // the largest key of a clustered table
+};
+
+#endif // TABLEWRITER_H
@@ -0,0 +1,259 @@
+/**
+ * ValueDictionary: the dictionary of the value column of a table.
+ *
+ * Each page of the dictionary file starts with the number of values
+ * stored in the page and the code of its first value, followed by the
+ * values as null-terminated strings. A value never spans two pages, and
+ * the code of a value is its position in the file, so the page of a code
+ * can be found from the first codes of the pages.
+ */
+
+#include "Bruinbase.h"
+#include "ValueDictionary.h"
+#include <cstdio>
+#include <cstring>
+
+using std::string;
+
+ValueDictionary::ValueDictionary()
+{
+  mode = 'r';
+  valueCount = 0;
+  complete = true;
+  lastPid = 0;
+  lastUsed = 2 * sizeof(int);
+  dirty = false;
+}
+
+RC ValueDictionary::create(const string& filename)
+{
+  RC rc;
+
+  // start from an empty file
+  remove(filename.c_str());
+  if ((rc = pf.open(filename, 'w')) < 0) return rc;
+
+  mode = 'w';
+  valueCount = 0;
+  complete = true;
+  values.clear();
+  codes.clear();
+  pageFirst.assign(1, 0);
+  pageCount.assign(1, 0);
+
+  // write the (empty) first page at close() even if no value is added
+  lastPid = 0;
+  lastUsed = 2 * sizeof(int);
+  memset(page, 0, PageFile::PAGE_SIZE);
+  dirty = true;
+
+  return 0;
+}
+
+RC ValueDictionary::open(const string& filename, char mode)
+{
+  RC rc;
+
+  if ((rc = pf.open(filename, mode)) < 0) return rc;
+
+  // opening in 'w' mode creates the file. an empty file is no dictionary.
+  if (pf.endPid() == 0) {
+    pf.close();
+    remove(filename.c_str());
+    return RC_FILE_OPEN_FAILED;
+  }
+
+  // the pages are read when a value or a code is first looked up
+  this->mode = mode;
+  valueCount = -1;
+  complete = false;
+  values.clear();
+  codes.clear();
+  pageFirst.assign(pf.endPid(), -1);
+  pageCount.assign(pf.endPid(), 0);
+  lastPid = pf.endPid() - 1;
+  dirty = false;
+
+  return 0;
+}
+
+RC ValueDictionary::readLast()
+{
+  RC  rc;
+  int count, first;
+
+  if (valueCount >= 0) return 0;
+
+  // the last page stays in memory for the values added to it
+  if ((rc = pf.read(lastPid, page)) < 0) return rc;
+  memcpy(&count, page, sizeof(int));
+  memcpy(&first, page + sizeof(int), sizeof(int));
+  if (count < 0 || first < 0 || (lastPid == 0 && first != 0)) return RC_INVALID_FILE_FORMAT;
+
+  valueCount = first + count;
+  values.resize(valueCount);
+  return readPage(lastPid);
+}
+
+RC ValueDictionary::readPage(PageId pid)
+{
+  RC    rc;
+  int   count, first, used;
+  char  buf[PageFile::PAGE_SIZE];
+  char* src = buf;
+
+  if (pageFirst[pid] >= 0) return 0;
+
+  if (pid == lastPid) {
+    src = page;
+  } else if ((rc = pf.read(pid, buf)) < 0) {
+    return rc;
+  }
+  memcpy(&count, src, sizeof(int));
+  memcpy(&first, src + sizeof(int), sizeof(int));
+  if (count < 0 || first < 0 || first + count > valueCount || (pid == 0 && first != 0))
+    return RC_INVALID_FILE_FORMAT;
+
+  used = 2 * sizeof(int);
+  for (int i = 0; i < count; i++) {
+    if (used >= PageFile::PAGE_SIZE) return RC_INVALID_FILE_FORMAT;
+    values[first + i] = src + used;
+    used += strlen(src + used) + 1;
+  }
+  if (pid == lastPid) lastUsed = used;
+  pageFirst[pid] = first;
+  pageCount[pid] = count;
+
+  return 0;
+}
+
+RC ValueDictionary::readAll()
+{
+  RC rc;
+
+  if (complete) return 0;
+  if ((rc = readLast()) < 0) return rc;
+  for (PageId pid = 0; pid <= lastPid; pid++) {
+    if ((rc = readPage(pid)) < 0) return rc;
+  }
+  for (int i = 0; i < valueCount; i++) {
+    codes[values[i]] = i;
+  }
+  complete = true;
+
+  return 0;
+}
+
+RC ValueDictionary::close()
+{
+  RC rc;
+
+  if ((rc = flush()) < 0) {
+    pf.close();
+    return rc;
+  }
+  values.clear();
+  codes.clear();
+  pageFirst.clear();
+  pageCount.clear();
+
+  return pf.close();
+}
+
+RC ValueDictionary::flush()
+{
+  RC rc;
+
+  if (!dirty) return 0;
+  if ((rc = pf.write(lastPid, page)) < 0) return rc;
+  dirty = false;
+
+  return 0;
+}
+
+RC ValueDictionary::encode(const string& value, int& code)
+{
+  RC  rc;
+  int count;
+
+  if ((rc = readAll()) < 0) return rc;
+  if (find(value, code) == 0) return 0;
+  if (mode != 'w' && mode != 'W') return RC_INVALID_FILE_MODE;
+
+  // start a new page if the value does not fit in the last one
+  int len = value.size() + 1;
+  if (len > PageFile::PAGE_SIZE - 2 * (int) sizeof(int)) return RC_INVALID_ATTRIBUTE;
+  if (lastUsed + len > PageFile::PAGE_SIZE) {
+    if ((rc = flush()) < 0) return rc;
+    lastPid++;
+    lastUsed = 2 * sizeof(int);
+    memset(page, 0, PageFile::PAGE_SIZE);
+    memcpy(page + sizeof(int), &valueCount, sizeof(int));
+    pageFirst.push_back(valueCount);
+    pageCount.push_back(0);
+  }
+
+  // append the value to the last page
+  memcpy(page + lastUsed, value.c_str(), len);
+  lastUsed += len;
+  memcpy(&count, page, sizeof(int));
+  count++;
+  memcpy(page, &count, sizeof(int));
+  dirty = true;
+
+  pageCount[lastPid]++;
+  code = valueCount++;
+  codes[value] = code;
+  values.push_back(value);
+
+  return 0;
+}
+
+RC ValueDictionary::find(const string& value, int& code)
+{
+  RC rc;
+
+  if ((rc = readAll()) < 0) return rc;
+
+  std::map<string, int>::const_iterator it = codes.find(value);
+  if (it == codes.end()) return RC_NO_SUCH_RECORD;
+  code = it->second;
+
+  return 0;
+}
+
+RC ValueDictionary::decode(int code, string& value)
+{
+  RC rc;
+
+  if ((rc = readLast()) < 0) return rc;
+  if (code < 0 || code >= valueCount) return RC_NO_SUCH_RECORD;
+
+  // the values are about the same size, so the page of a code is guessed
+  // from its position among the codes of the pages still in question.
+  // usually only the guessed page is read.
+  PageId lo = 0, hi = lastPid;
+  int    loCode = 0, hiCode = valueCount;
+  while (!complete) {
+    if (lo > hi) return RC_INVALID_FILE_FORMAT;
+    PageId pid = lo + (PageId) ((long long) (code - loCode) * (hi - lo + 1) / (hiCode - loCode));
+    if ((rc = readPage(pid)) < 0) return rc;
+    if (code < pageFirst[pid]) {
+      hi = pid - 1;
+      hiCode = pageFirst[pid];
+    } else if (code >= pageFirst[pid] + pageCount[pid]) {
+      lo = pid + 1;
+      loCode = pageFirst[pid] + pageCount[pid];
+    } else {
+      break;
+    }
+  }
+  value = values[code];
+
+  return 0;
+}
+
+int ValueDictionary::size()
+{
+  return (readLast() < 0) ? 0 : valueCount;
+}
@@ -0,0 +1,110 @@
+/**
+ * ValueDictionary: the dictionary of the value column of a table.
+ *
+ * Every distinct value of the table is stored once in the dictionary and
+ * gets an integer code, in the order the values are first seen. A table
+ * with a dictionary stores the code of the value in its records instead
+ * of the value itself (see RecordFile), so the records are much smaller
+ * and an equality condition on the value becomes an integer comparison.
+ */
+
+#ifndef VALUEDICTIONARY_H
+#define VALUEDICTIONARY_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Bruinbase.h"
+#include "PageFile.h"
+
+class ValueDictionary {
+ public:
+
+  ValueDictionary();
+
+  /**
+   * create a new, empty dictionary file.
+   * an existing file with the same name is overwritten.
+   * the dictionary is open in 'w' mode afterwards.
+   * @param filename[IN] the name of the dictionary file
+   * @return error code. 0 if no error
+   */
+  RC create(const std::string& filename);
+
+  /**
+   * open an existing dictionary file in read or write mode.
+   * no page is read yet: decode() reads only the pages of the codes
+   * it is given, and find() and encode() read the whole dictionary.
+   * @param filename[IN] the name of the dictionary file
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename, char mode);
+
+  /**
+   * write the new values to the disk and close the file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * get the code of a value, adding the value to the dictionary
+   * if it is not there yet. the dictionary must be open in 'w' mode.
+   * @param value[IN] the value to encode
+   * @param code[OUT] the code of the value
+   * @return error code. 0 if no error
+   */
+  RC encode(const std::string& value, int& code);
+
+  /**
+   * get the code of a value without modifying the dictionary.
+   * @param value[IN] the value to look for
+   * @param code[OUT] the code of the value
+   * @return error code. RC_NO_SUCH_RECORD if the value is not in the dictionary
+   */
+  RC find(const std::string& value, int& code);
+
+  /**
+   * get the value of a code.
+   * @param code[IN] the code to decode
+   * @param value[OUT] the value of the code
+   * @return error code. 0 if no error
+   */
+  RC decode(int code, std::string& value);
+
+  /**
+   * @return the number of values in the dictionary
+   */
+  int size();
+
+ private:
+  // read the last page of the file, which tells the number of values
+  RC readLast();
+
+  // read the values of a page into memory unless they are there already
+  RC readPage(PageId pid);
+
+  // read all values into memory and build the code of each value
+  RC readAll();
+
+  // write the last page of the file kept in memory to the disk
+  RC flush();
+
+  PageFile pf;         // the PageFile used to store the dictionary
+  char     mode;       // the mode the file was opened in
+  int      valueCount; // # values in the dictionary. -1 until the last page is read
+  bool     complete;   // true if all values are in memory and codes is built
+  std::vector<std::string>   values;  // the values, indexed by their code
+  std::vector<int>           pageFirst;  // the first code of each page. -1 if not read yet
+  std::vector<int>           pageCount;  // the number of values in each page read
+  std::map<std::string, int> codes;   // the code of each value
+
+  // the values are packed into pages as null-terminated strings.
+  // new values go to the last page, which is kept in memory.
+  PageId   lastPid;    // the last page of the file
+  int      lastUsed;   // # bytes used in the last page
+  bool     dirty;      // true if the last page has not been written
+  char     page[PageFile::PAGE_SIZE]; // the last page of the file
+};
+
+#endif // VALUEDICTIONARY_H
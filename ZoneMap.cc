@@ -0,0 +1,140 @@
+/**
+ * ZoneMap: a small sidecar file that summarizes a RecordFile.
+ *
+ * Page 0 of the zone map file stores the number of zones. The zone
+ * entries follow from page 1, ZONES_PER_PAGE entries per page.
+ */
+
+#include "Bruinbase.h"
+#include "ZoneMap.h"
+#include <cstring>
+
+using std::string;
+
+ZoneMap::ZoneMap()
+{
+  zoneCount = 0;
+  countDirty = false;
+  cachedPid = -1;
+  dirty = false;
+}
+
+RC ZoneMap::open(const string& filename, char mode)
+{
+  RC rc;
+
+  if ((rc = pf.open(filename, mode)) < 0) return rc;
+
+  zoneCount = 0;
+  countDirty = false;
+  cachedPid = -1;
+  dirty = false;
+
+  // an empty file has no zones yet
+  if (pf.endPid() == 0) return 0;
+
+  // the first four bytes of page 0 store the number of zones
+  if ((rc = pf.read(0, page)) < 0) {
+    pf.close();
+    return rc;
+  }
+  memcpy(&zoneCount, page, sizeof(int));
+
+  return 0;
+}
+
+RC ZoneMap::close()
+{
+  RC rc;
+
+  if ((rc = flush()) < 0) return rc;
+
+  // save the number of zones before closing
+  if (countDirty) {
+    memset(page, 0, PageFile::PAGE_SIZE);
+    memcpy(page, &zoneCount, sizeof(int));
+    if ((rc = pf.write(0, page)) < 0) return rc;
+    countDirty = false;
+  }
+  cachedPid = -1;
+
+  return pf.close();
+}
+
+RC ZoneMap::flush()
+{
+  RC rc;
+
+  if (!dirty) return 0;
+  if ((rc = pf.write(cachedPid, page)) < 0) return rc;
+  dirty = false;
+
+  return 0;
+}
+
+RC ZoneMap::update(const RecordId& rid, int key, const string& value)
+{
+  RC rc;
+  int zid = zoneOf(rid);
+  PageId pid = pageOf(zid);
+
+  // bring the page with the zone into memory
+  if (pid != cachedPid) {
+    if ((rc = flush()) < 0) return rc;
+    if (pid < pf.endPid()) {
+      if ((rc = pf.read(pid, page)) < 0) return rc;
+    } else {
+      memset(page, 0, PageFile::PAGE_SIZE);
+    }
+    cachedPid = pid;
+  }
+
+  // the value is stored in the table truncated to MAX_VALUE_LENGTH - 1
+  char v[RecordFile::MAX_VALUE_LENGTH];
+  strncpy(v, value.c_str(), RecordFile::MAX_VALUE_LENGTH - 1);
+  v[RecordFile::MAX_VALUE_LENGTH - 1] = 0;
+
+  // widen the zone to cover the tuple
+  Zone* zone = (Zone*) page + zid % ZONES_PER_PAGE;
+  if (zone->count == 0) {
+    zone->minKey = zone->maxKey = key;
+    strcpy(zone->minValue, v);
+    strcpy(zone->maxValue, v);
+  } else {
+    if (key < zone->minKey) zone->minKey = key;
+    if (key > zone->maxKey) zone->maxKey = key;
+    if (strcmp(v, zone->minValue) < 0) strcpy(zone->minValue, v);
+    if (strcmp(v, zone->maxValue) > 0) strcpy(zone->maxValue, v);
+  }
+  zone->count++;
+  dirty = true;
+
+  if (zid >= zoneCount) {
+    zoneCount = zid + 1;
+    countDirty = true;
+  }
+
+  return 0;
+}
+
+RC ZoneMap::read(int zid, Zone& zone) const
+{
+  RC rc;
+  char buf[PageFile::PAGE_SIZE];
+  const char* src = buf;
+  PageId pid = pageOf(zid);
+
+  if (zid < 0 || zid >= zoneCount) return RC_INVALID_PID;
+
+  if (pid == cachedPid) {
+    src = page;
+  } else if (pid >= pf.endPid()) {
+    // the zone was never written, so it has no tuple
+    memset(buf, 0, PageFile::PAGE_SIZE);
+  } else if ((rc = pf.read(pid, buf)) < 0) {
+    return rc;
+  }
+  memcpy(&zone, (const Zone*) src + zid % ZONES_PER_PAGE, sizeof(Zone));
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * ZoneMap: a small sidecar file that summarizes a RecordFile.
+ *
+ * The pages of a table are grouped into zones of ZONE_PAGES consecutive
+ * pages, and for every zone we remember the min/max key and the min/max
+ * value of the tuples stored in it. A table scan can then skip all pages
+ * of a zone whose range cannot satisfy the WHERE clause.
+ */
+
+#ifndef ZONEMAP_H
+#define ZONEMAP_H
+
+#include <string>
+#include "Bruinbase.h"
+#include "PageFile.h"
+#include "RecordFile.h"
+
+class ZoneMap {
+ public:
+
+  // number of table pages summarized by one zone
+  static const int ZONE_PAGES = 4;
+
+  /**
+   * the summary of one zone.
+   * a zone with (count == 0) has not seen any tuple yet.
+   */
+  struct Zone {
+    int  count;                                  // # tuples in the zone
+    int  minKey;                                 // smallest key
+    int  maxKey;                                 // largest key
+    char minValue[RecordFile::MAX_VALUE_LENGTH]; // smallest value
+    char maxValue[RecordFile::MAX_VALUE_LENGTH]; // largest value
+  };
+
+  // number of zone entries stored in one page of the zone map file
+  static const int ZONES_PER_PAGE = PageFile::PAGE_SIZE / sizeof(Zone);
+
+  ZoneMap();
+
+  /**
+   * open the zone map file in read or write mode.
+   * under 'w' mode, the file is created if it does not exist.
+   * @param filename[IN] the name of the zone map file
+   * @param mode[IN] 'r' for read, 'w' for write
+   * @return error code. 0 if no error
+   */
+  RC open(const std::string& filename, char mode);
+
+  /**
+   * write the pending changes to the disk and close the file.
+   * @return error code. 0 if no error
+   */
+  RC close();
+
+  /**
+   * widen the zone that contains rid so that it covers (key, value).
+   * @param rid[IN] the location of the tuple in the table
+   * @param key[IN] the key of the tuple
+   * @param value[IN] the value of the tuple
+   * @return error code. 0 if no error
+   */
+  RC update(const RecordId& rid, int key, const std::string& value);
+
+  /**
+   * read the summary of a zone.
+   * @param zid[IN] the zone to read. 0 <= zid < getZoneCount()
+   * @param zone[OUT] the summary of the zone
+   * @return error code. 0 if no error
+   */
+  RC read(int zid, Zone& zone) const;
+
+  /**
+   * @return the number of zones in the zone map
+   */
+  int getZoneCount() const { return zoneCount; }
+
+  /**
+   * @param rid[IN] a record id of the table
+   * @return the zone that contains the record
+   */
+  static int zoneOf(const RecordId& rid) { return rid.pid / ZONE_PAGES; }
+
+ private:
+  // write the zone map page kept in memory to the disk
+  RC flush();
+
+  // the page of the zone map file that stores zone zid
+  static PageId pageOf(int zid) { return 1 + zid / ZONES_PER_PAGE; }
+
+  PageFile pf;         // the PageFile used to store the zone map
+  int      zoneCount;  // the number of zones in the file
+  bool     countDirty; // true if zoneCount has not been written
+  PageId   cachedPid;  // the zone map page kept in memory (-1 if none)
+  bool     dirty;      // true if the cached page has not been written
+  char     page[PageFile::PAGE_SIZE]; // the cached zone map page
+};
+
+#endif // ZONEMAP_H
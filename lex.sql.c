@@ -387,8 +387,8 @@ static void yy_fatal_error (yyconst char msg[]  );
 	*yy_cp = '\0'; \
 	(yy_c_buf_p) = yy_cp;
 
-#define YY_NUM_RULES 26
-#define YY_END_OF_BUFFER 27
+#define YY_NUM_RULES 49
+#define YY_END_OF_BUFFER 50
 /* This struct is not used in this scanner,
    but its presence is necessary. */
 struct yy_trans_info
@@ -396,21 +396,37 @@ struct yy_trans_info
 	flex_int32_t yy_verify;
 	flex_int32_t yy_nxt;
 	};
-static yyconst flex_int16_t yy_accept[113] =
+static yyconst flex_int16_t yy_accept[264] =
     {   0,
-        0,    0,   27,   26,   25,   23,   26,   26,   22,   21,
-       26,   18,   24,   15,   12,   14,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   25,   23,    0,
-       19,   18,   17,   13,   16,   20,   20,   20,   20,   20,
-       20,   20,   11,   20,   20,   20,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   10,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,   20,   20,   20,
-       20,   20,   20,   20,   20,   20,   20,    8,    2,   20,
-        4,    7,   20,   20,    5,   20,   20,   20,   20,   20,
-
-        6,   20,    3,   20,   20,    0,    1,    0,    0,    0,
-        9,    0
+        0,    0,   50,   49,   48,   46,   49,   49,   43,   44,
+       45,   42,   49,   39,   47,   36,   33,   35,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,    0,
+       40,   38,   34,   37,   41,   41,   41,   24,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   32,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   32,   41,   41,   41,   41,   41,   41,   41,   31,
+
+       25,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   22,   41,   41,   41,
+       41,   10,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   26,   41,
+       29,   41,    2,   41,   41,   41,    6,   41,    4,   41,
+       41,   28,   41,   41,   41,   41,   41,   41,   15,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   17,   13,
+
+       41,   41,   41,   41,   41,   41,   16,   41,   27,   23,
+       41,   41,   14,   41,   41,   41,    3,   41,   41,   41,
+       41,   41,   41,   41,   41,   41,   41,   41,   41,    0,
+        8,   41,   12,   21,    5,   41,    1,    9,   11,    7,
+       41,   41,   41,   41,    0,   41,   41,   41,   41,   41,
+       41,   30,   41,   41,   41,   41,   41,   19,   41,   20,
+       41,   18,    0
     } ;
 
 static yyconst flex_int32_t yy_ec[256] =
@@ -422,13 +438,13 @@ static yyconst flex_int32_t yy_ec[256] =
         7,    8,    1,    9,   10,    1,    1,   11,   11,   11,
        11,   11,   11,   11,   11,   11,   11,    1,   12,   13,
        14,   15,    1,    1,   16,   17,   18,   19,   20,   21,
-       17,   22,   23,   17,   17,   24,   25,   26,   27,   17,
-       28,   29,   30,   31,   32,   17,   33,   34,   17,   17,
-        1,    1,    1,    1,   35,    1,   36,   17,   37,   38,
+       22,   23,   24,   25,   25,   26,   27,   28,   29,   30,
+       31,   32,   33,   34,   35,   36,   37,   38,   39,   40,
+        1,    1,    1,    1,   41,    1,   42,   43,   44,   45,
 
-       39,   40,   17,   41,   42,   17,   17,   43,   44,   45,
-       46,   17,   47,   48,   49,   50,   51,   17,   52,   53,
-       17,   17,    1,    1,    1,    1,    1,    1,    1,    1,
+       46,   47,   48,   49,   50,   25,   25,   51,   52,   53,
+       54,   55,   56,   57,   58,   59,   60,   61,   62,   63,
+       64,   65,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
@@ -445,100 +461,209 @@ static yyconst flex_int32_t yy_ec[256] =
         1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_int32_t yy_meta[54] =
+static yyconst flex_int32_t yy_meta[66] =
     {   0,
-        1,    1,    1,    1,    1,    1,    1,    1,    1,    2,
-        2,    1,    1,    1,    1,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2,    2,    2,    2,    2,    2,    2,    2,
-        2,    2,    2
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    1,    1,    1,    1
     } ;
 
-static yyconst flex_int16_t yy_base[115] =
+static yyconst flex_int16_t yy_base[264] =
     {   0,
-        0,    0,  144,  145,  141,  145,  139,  136,  145,  145,
-      129,  128,  145,   40,  145,  124,  111,    0,  109,  101,
-      105,  107,  105,  102,   98,  109,   34,   83,   81,   73,
-       77,   79,   77,   74,   70,   81,   17,  117,  145,  113,
-      145,  106,  145,  145,  145,    0,   97,   83,   91,   86,
-       93,   95,    0,   87,   85,   88,   76,   68,   54,   62,
-       57,   64,   65,   58,   56,   59,   47,    0,   70,   64,
-       69,   73,   73,   60,   70,   60,   66,   42,   36,   41,
-       45,   45,   32,   42,   32,   38,   47,    0,    0,   43,
-        0,    0,   58,   55,    0,   24,   20,   35,   32,   64,
-
-        0,   38,    0,   62,   17,   58,    0,   57,   57,   56,
-      145,  145,   59,   60
+       66,    2,  279,    3,  289,    4,  305,  131,    5,    6,
+        7,    8,  301,    9,   10,  204,   11,  302,  196,  195,
+      233,  240,  237,  250,  277,  290,  245,  285,  284,  300,
+      306,  291,  308,  260,  234,  235,  194,  248,  262,  269,
+      274,  213,  271,  270,  283,  292,  276,  293,  246,   12,
+       13,   14,   15,   16,  313,  315,  307,   17,  319,  303,
+      304,  218,  322,  317,  206,  247,  316,  326,  318,  278,
+      320,  227,  329,  328,  259,  330,  314,  309,  311,  295,
+      312,  297,  298,  251,  321,  310,  257,  231,  299,  324,
+      323,  256,  327,  254,  325,  331,  263,  332,  294,   18,
+
+       19,  333,  336,  334,  335,  341,  346,  337,  338,  349,
+      266,  350,  353,  345,  355,  361,   20,  362,  365,  351,
+      363,   21,  358,  370,  352,  354,  356,  367,  339,  342,
+      340,  343,  348,  357,  344,  347,  359,  258,  364,  366,
+      360,  368,  371,  369,  375,  372,  373,  374,  378,  376,
+      377,  381,  379,  380,  382,  387,  388,  389,   22,  384,
+       23,  386,   24,  391,  392,  395,   25,  390,   26,  397,
+      385,   27,  414,  413,  400,  404,  415,  420,   28,  393,
+      396,  394,  398,  399,  401,  287,  402,  383,  403,  405,
+      406,  408,  410,  409,  407,  411,  416,  419,   29,   30,
+
+      421,  437,  424,  418,  429,  422,   31,  425,   32,   33,
+      428,  433,   34,  436,  441,  439,   35,  423,  427,  426,
+      430,  417,  431,  432,  434,  435,  440,  438,  442,  467,
+       36,  449,   37,   38,   39,  443,   40,   41,   42,   43,
+      444,  445,  446,  458,  472,  468,  465,  448,  447,  451,
+      469,   44,  454,  476,  455,  450,  457,   45,  452,   46,
+      453,   47,    1
     } ;
 
-static yyconst flex_int16_t yy_def[115] =
+static yyconst flex_int16_t yy_def[264] =
     {   0,
-      112,    1,  112,  112,  112,  112,  112,  113,  112,  112,
-      112,  112,  112,  112,  112,  112,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  112,  112,  113,
-      112,  112,  112,  112,  112,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-      114,  114,  114,  114,  114,  114,  114,  114,  114,  114,
-
-      114,  114,  114,  114,  114,  112,  114,  112,  112,  112,
-      112,    0,  112,  112
+      263,    1,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,   13,  263,  263,  263,  263,    1,   19,
+       20,   19,   19,   23,   23,   25,   25,   24,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,    8,
+      263,  263,  263,  263,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   24,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   23,   24,   25,   25,   25,   24,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,   25,   25,   25,   25,   24,  263,
+       25,   25,   25,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,   25,   25,  263,   25,   25,   25,   25,   25,
+       25,  263,   24,   25,   25,   25,   25,   25,   25,   25,
+       25,   25,    0
     } ;
 
-static yyconst flex_int16_t yy_nxt[199] =
+static yyconst flex_int16_t yy_nxt[542] =
     {   0,
-        4,    5,    6,    7,    8,    4,    4,    9,   10,   11,
-       12,   13,   14,   15,   16,   17,   18,   19,   18,   20,
-       21,   18,   22,   23,   18,   18,   24,   25,   18,   26,
-       18,   18,   27,   18,    4,   28,   29,   18,   30,   31,
-       18,   32,   33,   18,   18,   34,   35,   18,   36,   18,
-       18,   37,   18,   43,   44,   56,   57,   66,   67,   40,
-       40,   46,  111,  111,  110,  109,  107,  108,  107,  106,
-      103,  105,  101,  104,  103,  102,  101,  100,   95,   99,
-       98,   92,   91,   97,   89,   88,   96,   95,   94,   93,
-       92,   91,   90,   89,   88,   87,   86,   85,   84,   83,
-
-       82,   81,   80,   79,   78,   68,   77,   76,   75,   74,
-       73,   72,   71,   70,   69,   68,   42,   41,   38,   65,
-       64,   53,   63,   62,   61,   60,   59,   58,   55,   54,
-       53,   52,   51,   50,   49,   48,   47,   45,   42,   42,
-       41,   39,   38,  112,    3,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112
-
+        3,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,    4,    5,    6,    7,
+        8,    9,   10,   11,   12,   13,   14,   15,   16,   17,
+       18,   19,   20,   21,   22,   23,   24,   25,   25,   26,
+       25,   27,   25,   25,   28,   25,   29,   25,   30,   31,
+
+       32,   33,   34,   25,   25,   25,    4,   35,   36,   37,
+       38,   39,   40,   25,   25,   41,   42,   25,   25,   43,
+       25,   44,   25,   45,   46,   47,   48,   49,   25,   25,
+       25,   50,   50,   50,   50,   51,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,   50,   50,   50,   50,
+       50,   50,   50,   50,   50,   50,  263,  263,  263,  263,
+
+      263,  263,  263,  263,  263,   25,   25,  263,  263,  263,
+      263,   25,   25,   25,   25,   25,   25,   52,   53,   25,
+       57,   25,   25,   55,   25,  110,   25,   25,   56,   25,
+       25,   25,   25,   58,  111,   81,   25,   25,   25,   25,
+       25,   25,   25,  106,   82,   25,   25,   83,   59,   25,
+      107,   25,  121,   25,   25,   25,   25,   25,   60,   62,
+      122,   61,   89,   63,   25,  112,   90,   25,   67,   25,
+       91,   25,   25,   68,   64,  139,  125,   69,  263,  113,
+      114,   65,   76,   77,  126,   80,   78,   25,  140,  141,
+        5,   79,  163,   84,   98,   99,  118,   85,   58,  119,
+
+      144,  133,  137,  145,  147,  164,  150,    6,  134,  163,
+      138,   14,  122,  151,   25,   54,   70,   66,   71,   72,
+       74,   73,  187,   75,   86,   87,   88,   92,   94,   93,
+       96,  100,  101,   95,   97,  102,  103,  104,  105,  108,
+      109,  116,  115,  120,  117,  123,  124,  128,  129,  127,
+      142,  221,  153,  100,  101,  130,  131,  132,  155,  136,
+      158,  154,  157,  159,  135,  143,  156,  148,  162,  165,
+      160,  161,  166,  167,  117,  149,  146,  152,  168,  169,
+      171,  170,  173,  174,  172,  175,  176,  178,  177,  179,
+      181,    0,  180,  184,    0,  183,    0,  182,    0,    0,
+
+      159,  200,  185,    0,  186,  161,  199,  204,    0,  188,
+      206,  189,  211,  167,  191,  169,  192,  190,  193,  195,
+      201,  202,  203,  209,  194,  205,  208,  179,  210,  207,
+      172,  212,  213,  214,  216,  196,  197,  198,  215,  217,
+      229,  200,  230,  231,  199,  207,  232,  222,  233,  234,
+      220,  236,  218,  225,  213,  238,  202,  219,  235,  223,
+      224,  228,  210,  209,  217,  226,  237,  239,  241,  234,
+      227,  240,  231,  244,  245,  233,  246,  251,  252,  242,
+      238,  243,  247,  253,  254,  259,    0,  258,  256,  235,
+      262,  239,  237,  255,  260,  240,  257,  249,    0,  258,
+
+      248,  260,    0,    0,    0,    0,  261,    0,    0,    0,
+      250,    0,    0,    0,    0,    0,  262,    0,    0,    0,
+        0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        0
     } ;
 
-static yyconst flex_int16_t yy_chk[199] =
+static yyconst flex_int16_t yy_chk[542] =
     {   0,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,  263,  263,  263,  263,
+      263,  263,  263,  263,  263,  263,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
         1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
-        1,    1,    1,   14,   14,   27,   27,   37,   37,  113,
-      113,  114,  110,  109,  108,  106,  105,  104,  102,  100,
-       99,   98,   97,   96,   94,   93,   90,   87,   86,   85,
-       84,   83,   82,   81,   80,   79,   78,   77,   76,   75,
-       74,   73,   72,   71,   70,   69,   67,   66,   65,   64,
-
-       63,   62,   61,   60,   59,   58,   57,   56,   55,   54,
-       52,   51,   50,   49,   48,   47,   42,   40,   38,   36,
-       35,   34,   33,   32,   31,   30,   29,   28,   26,   25,
-       24,   23,   22,   21,   20,   19,   17,   16,   12,   11,
-        8,    7,    5,    3,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112,  112,  112,
-      112,  112,  112,  112,  112,  112,  112,  112
-
+        1,    1,    1,    1,    1,    1,    1,    1,    1,    1,
+        1,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,    8,    8,    8,    8,
+        8,    8,    8,    8,    8,    8,   19,   19,   19,   19,
+
+       19,   19,   19,   19,   19,   19,   19,   19,   19,   19,
+       19,   19,   19,   19,   19,   19,   19,   16,   16,   19,
+       20,   19,   20,   19,   19,   65,   19,   20,   19,   19,
+       19,   19,   19,   20,   65,   37,   19,   19,   19,   19,
+       19,   19,   19,   62,   37,   19,   19,   37,   21,   19,
+       62,   19,   72,   19,   19,   19,   19,   19,   21,   22,
+       72,   21,   42,   22,   23,   66,   42,   22,   27,   23,
+       42,   21,   22,   27,   23,   88,   75,   27,    3,   66,
+       66,   24,   34,   34,   75,   36,   35,   24,   88,   88,
+        5,   35,  111,   38,   49,   49,   70,   38,   36,   70,
+
+       92,   84,   87,   92,   94,  111,   97,    7,   84,  138,
+       87,   13,   94,   97,   25,   18,   28,   26,   29,   30,
+       32,   31,  138,   33,   39,   40,   41,   43,   45,   44,
+       47,   55,   56,   46,   48,   57,   59,   60,   61,   63,
+       64,   68,   67,   71,   69,   73,   74,   77,   80,   76,
+       89,  186,   99,   78,   79,   81,   82,   83,  103,   86,
+      106,  102,  105,  107,   85,   90,  104,   95,  110,  112,
+      108,  109,  113,  114,   91,   96,   93,   98,  115,  116,
+      119,  118,  121,  123,  120,  124,  125,  127,  126,  128,
+      130,    0,  129,  133,    0,  132,    0,  131,    0,    0,
+
+      134,  155,  135,    0,  137,  136,  154,  160,    0,  139,
+      164,  140,  171,  141,  144,  143,  145,  142,  147,  149,
+      156,  157,  158,  168,  148,  162,  166,  153,  170,  165,
+      146,  173,  174,  175,  177,  150,  151,  152,  176,  178,
+      201,  181,  202,  203,  180,  188,  204,  187,  205,  206,
+      185,  211,  182,  193,  194,  214,  183,  184,  208,  189,
+      192,  197,  191,  190,  198,  195,  212,  215,  218,  222,
+      196,  216,  219,  229,  230,  221,  232,  244,  245,  220,
+      226,  224,  236,  246,  247,  253,    0,  251,  249,  223,
+      259,  227,  225,  248,  254,  228,  250,  242,    0,  255,
+
+      241,  257,    0,    0,    0,    0,  256,    0,    0,    0,
+      243,    0,    0,    0,    0,    0,  261,    0,    0,    0,
+        0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        0,    0,    0,    0,    0,    0,    0,    0,    0,    0,
+        0
     } ;
 
 static yy_state_type yy_last_accepting_state;
@@ -570,7 +695,7 @@ char* strlower(char* s)
         }
 	return s;
 }
-#line 574 "lex.sql.c"
+#line 699 "lex.sql.c"
 
 #define INITIAL 0
 
@@ -760,7 +885,7 @@ YY_DECL
 #line 17 "SqlParser.l"
 
 
-#line 764 "lex.sql.c"
+#line 889 "lex.sql.c"
 
 	if ( !(yy_init) )
 		{
@@ -813,13 +938,13 @@ yy_match:
 			while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 				{
 				yy_current_state = (int) yy_def[yy_current_state];
-				if ( yy_current_state >= 113 )
+				if ( yy_current_state >= 264 )
 					yy_c = yy_meta[(unsigned int) yy_c];
 				}
 			yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
 			++yy_cp;
 			}
-		while ( yy_base[yy_current_state] != 145 );
+		while ( yy_base[yy_current_state] != 1 );
 
 yy_find_action:
 		yy_act = yy_accept[yy_current_state];
@@ -866,116 +991,231 @@ return LOAD;
 case 5:
 YY_RULE_SETUP
 #line 23 "SqlParser.l"
-return WITH;
+return INSERT;
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
 #line 24 "SqlParser.l"
-return INDEX;
+return INTO;
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
 #line 25 "SqlParser.l"
-return QUIT;
+return VALUES;
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
 #line 26 "SqlParser.l"
-return QUIT;
+return DELETE;
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
 #line 27 "SqlParser.l"
-return COUNT;
+return UPDATE;
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
-#line 29 "SqlParser.l"
-return AND;
+#line 28 "SqlParser.l"
+return SET;
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
-#line 30 "SqlParser.l"
-return OR;
+#line 29 "SqlParser.l"
+return VACUUM;
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
-#line 31 "SqlParser.l"
-return EQUAL;
+#line 30 "SqlParser.l"
+return FREEZE;
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
-#line 32 "SqlParser.l"
-return NEQUAL;
+#line 31 "SqlParser.l"
+return CACHE;
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
-#line 33 "SqlParser.l"
-return GREATER;
+#line 32 "SqlParser.l"
+return TABLE;
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
-#line 34 "SqlParser.l"
-return LESS;
+#line 33 "SqlParser.l"
+return WITH;
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
-#line 35 "SqlParser.l"
-return GREATEREQUAL;
+#line 34 "SqlParser.l"
+return INDEX;
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
-#line 36 "SqlParser.l"
-return LESSEQUAL;
+#line 35 "SqlParser.l"
+return BLOOM;
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
-#line 38 "SqlParser.l"
-sqllval.string = strdup(sqltext); return INTEGER;
+#line 36 "SqlParser.l"
+return DICTIONARY;
 	YY_BREAK
 case 19:
-/* rule 19 can match eol */
 YY_RULE_SETUP
-#line 39 "SqlParser.l"
-sqllval.string = strdup(sqltext+1); sqllval.string[sqlleng-2] = 0; return STRING;
+#line 37 "SqlParser.l"
+return CLUSTERED;
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
-#line 40 "SqlParser.l"
-sqllval.string = strlower(strdup(sqltext)); return ID;
+#line 38 "SqlParser.l"
+return ORGANIZED;
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
-#line 41 "SqlParser.l"
-return COMMA;
+#line 39 "SqlParser.l"
+return FROZEN;
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
-#line 42 "SqlParser.l"
-return STAR;
+#line 40 "SqlParser.l"
+return LSM;
 	YY_BREAK
 case 23:
-/* rule 23 can match eol */
 YY_RULE_SETUP
-#line 43 "SqlParser.l"
-return LF;
+#line 41 "SqlParser.l"
+return ORDER;
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
-#line 44 "SqlParser.l"
-/* ignore semicolon */
+#line 42 "SqlParser.l"
+return BY;
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
-#line 45 "SqlParser.l"
-/* ignore white space */
+#line 43 "SqlParser.l"
+return ASC;
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
+#line 44 "SqlParser.l"
+return DESC;
+	YY_BREAK
+case 27:
+YY_RULE_SETUP
+#line 45 "SqlParser.l"
+return LIMIT;
+	YY_BREAK
+case 28:
+YY_RULE_SETUP
+#line 46 "SqlParser.l"
+return QUIT;
+	YY_BREAK
+case 29:
+YY_RULE_SETUP
 #line 47 "SqlParser.l"
+return QUIT;
+	YY_BREAK
+case 30:
+YY_RULE_SETUP
+#line 48 "SqlParser.l"
+return COUNT;
+	YY_BREAK
+case 31:
+YY_RULE_SETUP
+#line 50 "SqlParser.l"
+return AND;
+	YY_BREAK
+case 32:
+YY_RULE_SETUP
+#line 51 "SqlParser.l"
+return OR;
+	YY_BREAK
+case 33:
+YY_RULE_SETUP
+#line 52 "SqlParser.l"
+return EQUAL;
+	YY_BREAK
+case 34:
+YY_RULE_SETUP
+#line 53 "SqlParser.l"
+return NEQUAL;
+	YY_BREAK
+case 35:
+YY_RULE_SETUP
+#line 54 "SqlParser.l"
+return GREATER;
+	YY_BREAK
+case 36:
+YY_RULE_SETUP
+#line 55 "SqlParser.l"
+return LESS;
+	YY_BREAK
+case 37:
+YY_RULE_SETUP
+#line 56 "SqlParser.l"
+return GREATEREQUAL;
+	YY_BREAK
+case 38:
+YY_RULE_SETUP
+#line 57 "SqlParser.l"
+return LESSEQUAL;
+	YY_BREAK
+case 39:
+YY_RULE_SETUP
+#line 59 "SqlParser.l"
+sqllval.string = strdup(sqltext); return INTEGER;
+	YY_BREAK
+case 40:
+/* rule 40 can match eol */
+YY_RULE_SETUP
+#line 60 "SqlParser.l"
+sqllval.string = strdup(sqltext+1); sqllval.string[sqlleng-2] = 0; return STRING;
+	YY_BREAK
+case 41:
+YY_RULE_SETUP
+#line 61 "SqlParser.l"
+sqllval.string = strlower(strdup(sqltext)); return ID;
+	YY_BREAK
+case 42:
+YY_RULE_SETUP
+#line 62 "SqlParser.l"
+return COMMA;
+	YY_BREAK
+case 43:
+YY_RULE_SETUP
+#line 63 "SqlParser.l"
+return LPAREN;
+	YY_BREAK
+case 44:
+YY_RULE_SETUP
+#line 64 "SqlParser.l"
+return RPAREN;
+	YY_BREAK
+case 45:
+YY_RULE_SETUP
+#line 65 "SqlParser.l"
+return STAR;
+	YY_BREAK
+case 46:
+/* rule 46 can match eol */
+YY_RULE_SETUP
+#line 66 "SqlParser.l"
+return LF;
+	YY_BREAK
+case 47:
+YY_RULE_SETUP
+#line 67 "SqlParser.l"
+/* ignore semicolon */
+	YY_BREAK
+case 48:
+YY_RULE_SETUP
+#line 68 "SqlParser.l"
+/* ignore white space */
+	YY_BREAK
+case 49:
+YY_RULE_SETUP
+#line 70 "SqlParser.l"
 ECHO;
 	YY_BREAK
-#line 979 "lex.sql.c"
+#line 1219 "lex.sql.c"
 case YY_STATE_EOF(INITIAL):
 	yyterminate();
 
@@ -1267,7 +1507,7 @@ static int yy_get_next_buffer (void)
 		while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 			{
 			yy_current_state = (int) yy_def[yy_current_state];
-			if ( yy_current_state >= 113 )
+			if ( yy_current_state >= 264 )
 				yy_c = yy_meta[(unsigned int) yy_c];
 			}
 		yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
@@ -1295,11 +1535,11 @@ static int yy_get_next_buffer (void)
 	while ( yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state )
 		{
 		yy_current_state = (int) yy_def[yy_current_state];
-		if ( yy_current_state >= 113 )
+		if ( yy_current_state >= 264 )
 			yy_c = yy_meta[(unsigned int) yy_c];
 		}
 	yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
-	yy_is_jam = (yy_current_state == 112);
+	yy_is_jam = (yy_current_state == 263);
 
 	return yy_is_jam ? 0 : yy_current_state;
 }
@@ -1973,7 +2213,7 @@ void sqlfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 47 "SqlParser.l"
+#line 70 "SqlParser.l"
 
 
 
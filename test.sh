@@ -1,10 +1,24 @@
 #!/bin/sh
 
-rm -f xsmall.tbl xsmall.idx
-rm -f small.tbl small.idx
-rm -f medium.tbl medium.idx
-rm -f large.tbl large.idx
-rm -f xlarge.tbl xlarge.idx
+rm -f xsmall.tbl xsmall.idx xsmall.zm
+rm -f small.tbl small.idx small.zm
+rm -f medium.tbl medium.idx medium.zm
+rm -f large.tbl large.idx large.zm
+rm -f xlarge.tbl xlarge.idx xlarge.zm
+rm -f zoned.tbl zoned.zm
+rm -f bloomed.tbl bloomed.zm
+rm -f *.bf
+rm -f dml.tbl dml.idx dml.zm
+rm -f sorted.tbl sorted.cl sorted.zm
+rm -f iot.iot
+rm -f runs.lsm runs.run*
+rm -f archive.sst
+rm -f sealed.sst
+rm -f cached.tbl cached.zm
+rm -f coded.tbl coded.idx coded.zm
+rm -f *.dict
+rm -f dups.tbl dups.idx dups.zm
+rm -f bulk.tbl bulk.idx bulk.zm
 
 ./bruinbase < test.sql
 
@@ -20,3 +20,129 @@ SELECT COUNT(*) FROM xlarge
 SELECT * FROM xlarge WHERE key = 4240
 SELECT * FROM xlarge WHERE key > 400 AND key < 500 AND key > 100 AND key < 4000000
 
+
+LOAD zoned FROM 'large.del'
+SELECT COUNT(*) FROM zoned WHERE key > 4500
+SELECT * FROM zoned WHERE key > 2330 AND key < 2350
+SELECT COUNT(*) FROM zoned WHERE key < 0
+SELECT key FROM zoned WHERE value = 'Blue Hawaii'
+LOAD zoned FROM 'xsmall.del'
+SELECT * FROM zoned WHERE key > 2330 AND key < 2350
+
+LOAD bloomed FROM 'medium.del' WITH BLOOM
+SELECT * FROM bloomed WHERE key = 489
+SELECT COUNT(*) FROM bloomed WHERE key = 490
+SELECT * FROM bloomed WHERE value = 'Blue Hawaii'
+SELECT COUNT(*) FROM bloomed WHERE value = 'No Such Title'
+LOAD bloomed FROM 'xsmall.del' WITH BLOOM
+INSERT INTO bloomed VALUES (7, 'Inserted')
+SELECT * FROM bloomed WHERE key = 2342
+SELECT * FROM bloomed WHERE key = 7
+SELECT key FROM bloomed WHERE value = 'Inserted'
+
+LOAD coded FROM 'small.del' WITH DICTIONARY, INDEX
+LOAD coded FROM 'xsmall.del'
+SELECT COUNT(*) FROM coded
+SELECT * FROM coded WHERE value = 'Last Ride, The'
+SELECT key FROM coded WHERE value <> 'Last Ride, The' AND key < 300
+SELECT COUNT(*) FROM coded WHERE value = 'No Such Title'
+SELECT * FROM coded WHERE key = 489
+SELECT value FROM coded WHERE key > 4580
+
+LOAD dml FROM 'small.del' WITH INDEX
+INSERT INTO dml VALUES (5000, 'Inserted Last'), (10, 'Inserted First')
+SELECT COUNT(*) FROM dml
+SELECT * FROM dml WHERE key < 100
+SELECT * FROM dml WHERE key > 4600
+DELETE FROM dml WHERE key > 500 AND key < 4500
+SELECT COUNT(*) FROM dml
+VACUUM dml
+SELECT COUNT(*) FROM dml
+SELECT * FROM dml WHERE key > 400 AND key < 4500
+UPDATE dml SET value = 'Updated' WHERE key = 489
+SELECT * FROM dml WHERE key = 489
+SELECT * FROM dml WHERE value = 'Updated'
+UPDATE dml SET value = 'Updated' WHERE key < 500
+SELECT * FROM dml WHERE key < 500
+UPDATE coded SET value = 'Last Ride, The' WHERE key > 2000 AND key < 2400
+SELECT * FROM coded WHERE value = 'Last Ride, The'
+
+LOAD sorted FROM 'small.del' WITH CLUSTERED
+SELECT * FROM sorted WHERE key > 4500
+SELECT key FROM sorted ORDER BY key DESC LIMIT 3
+
+LOAD iot FROM 'small.del' WITH ORGANIZED
+INSERT INTO iot VALUES (4700, 'Inserted')
+SELECT * FROM iot WHERE key > 4500
+
+LOAD runs FROM 'small.del' WITH LSM
+LOAD runs FROM 'xsmall.del' WITH LSM
+SELECT COUNT(*) FROM runs
+SELECT * FROM runs WHERE key > 2300 AND key < 2400
+INSERT INTO runs VALUES (2345, 'Inserted')
+UPDATE runs SET value = 'Updated' WHERE key = 2342
+DELETE FROM runs WHERE key < 1000
+SELECT COUNT(*) FROM runs
+SELECT * FROM runs WHERE key > 2300 AND key < 2400
+
+LOAD archive FROM 'small.del' WITH INDEX
+FREEZE archive
+SELECT COUNT(*) FROM archive
+SELECT * FROM archive WHERE key < 100
+DELETE FROM archive WHERE key < 100
+SELECT COUNT(*) FROM archive
+
+LOAD sealed FROM 'medium.del' WITH FROZEN
+SELECT COUNT(*) FROM sealed
+SELECT * FROM sealed WHERE key > 1500 AND key < 1700
+SELECT key FROM sealed WHERE key > 4500
+
+LOAD cached FROM 'xsmall.del'
+CACHE TABLE cached
+INSERT INTO cached VALUES (1, 'Cached')
+SELECT * FROM cached WHERE key < 1000
+
+LOAD dups FROM 'dups.del' WITH INDEX
+SELECT COUNT(*) FROM dups
+SELECT COUNT(*) FROM dups WHERE key = 0
+SELECT * FROM dups WHERE key = 0 AND value = 'Zero 699'
+SELECT * FROM dups WHERE key = 7
+SELECT * FROM dups WHERE key < 0
+SELECT COUNT(*) FROM dups WHERE key >= 0 AND key <= 1
+SELECT key FROM dups WHERE key > 0 AND key < 3
+DELETE FROM dups WHERE key = 0 AND value = 'Zero 1'
+INSERT INTO dups VALUES (0, 'Zero Again'), (7, 'Key 7 Again')
+SELECT COUNT(*) FROM dups WHERE key = 0
+SELECT * FROM dups WHERE key = 0 AND value > 'Zero 698'
+SELECT COUNT(*) FROM dups WHERE key = 7
+LOAD dups FROM 'dups.del'
+SELECT COUNT(*) FROM dups WHERE key = 0
+SELECT COUNT(*) FROM dups WHERE key <= 0
+
+SELECT * FROM large WHERE key > 4400 AND key < 4700 ORDER BY key DESC LIMIT 5
+SELECT key FROM xlarge ORDER BY key DESC LIMIT 4
+SELECT key FROM xlarge WHERE key <= 10 ORDER BY key DESC
+SELECT COUNT(*) FROM xlarge WHERE key > 100 ORDER BY key DESC
+SELECT COUNT(*) FROM xlarge WHERE key > 100
+SELECT key FROM dups WHERE key < 3 ORDER BY key DESC LIMIT 8
+SELECT COUNT(*) FROM dups WHERE key >= -5 AND key <= 0 ORDER BY key DESC
+SELECT * FROM dups WHERE key < 0 ORDER BY key DESC
+SELECT key FROM dups WHERE key > 20 ORDER BY key DESC
+SELECT key FROM iot WHERE key < 2000 ORDER BY key DESC LIMIT 3
+
+LOAD bulk FROM 'xlarge.del' WITH INDEX
+SELECT COUNT(*) FROM bulk WHERE key >= 4000 AND key <= 4200
+SELECT * FROM bulk WHERE key = 4003
+SELECT key FROM bulk WHERE key < 10
+INSERT INTO bulk VALUES (4002, 'Bulk 4002'), (4004, 'Bulk 4004'), (4006, 'Bulk 4006'), (4008, 'Bulk 4008'), (4010, 'Bulk 4010'), (4012, 'Bulk 4012'), (4014, 'Bulk 4014'), (4016, 'Bulk 4016'), (4018, 'Bulk 4018'), (4020, 'Bulk 4020'), (4022, 'Bulk 4022'), (4024, 'Bulk 4024'), (4026, 'Bulk 4026'), (4028, 'Bulk 4028'), (4030, 'Bulk 4030'), (4032, 'Bulk 4032'), (4034, 'Bulk 4034'), (4036, 'Bulk 4036'), (4038, 'Bulk 4038'), (4040, 'Bulk 4040'), (4042, 'Bulk 4042'), (4044, 'Bulk 4044'), (4046, 'Bulk 4046'), (4048, 'Bulk 4048'), (4050, 'Bulk 4050'), (4052, 'Bulk 4052'), (4054, 'Bulk 4054'), (4056, 'Bulk 4056'), (4058, 'Bulk 4058'), (4060, 'Bulk 4060'), (4062, 'Bulk 4062'), (4064, 'Bulk 4064'), (4066, 'Bulk 4066'), (4068, 'Bulk 4068'), (4070, 'Bulk 4070'), (4072, 'Bulk 4072'), (4074, 'Bulk 4074'), (4076, 'Bulk 4076'), (4078, 'Bulk 4078'), (4080, 'Bulk 4080'), (4082, 'Bulk 4082'), (4084, 'Bulk 4084'), (4086, 'Bulk 4086'), (4088, 'Bulk 4088'), (4090, 'Bulk 4090'), (4092, 'Bulk 4092'), (4094, 'Bulk 4094'), (4096, 'Bulk 4096'), (4098, 'Bulk 4098'), (4100, 'Bulk 4100'), (4102, 'Bulk 4102'), (4104, 'Bulk 4104'), (4106, 'Bulk 4106'), (4108, 'Bulk 4108'), (4110, 'Bulk 4110'), (4112, 'Bulk 4112'), (4114, 'Bulk 4114'), (4116, 'Bulk 4116'), (4118, 'Bulk 4118'), (4120, 'Bulk 4120'), (4122, 'Bulk 4122'), (4124, 'Bulk 4124'), (4126, 'Bulk 4126'), (4128, 'Bulk 4128'), (4130, 'Bulk 4130'), (4132, 'Bulk 4132'), (4134, 'Bulk 4134'), (4136, 'Bulk 4136'), (4138, 'Bulk 4138'), (4140, 'Bulk 4140'), (4142, 'Bulk 4142'), (4144, 'Bulk 4144'), (4146, 'Bulk 4146'), (4148, 'Bulk 4148'), (4150, 'Bulk 4150'), (4152, 'Bulk 4152'), (4154, 'Bulk 4154'), (4156, 'Bulk 4156'), (4158, 'Bulk 4158'), (4160, 'Bulk 4160'), (4162, 'Bulk 4162'), (4164, 'Bulk 4164'), (4166, 'Bulk 4166'), (4168, 'Bulk 4168'), (4170, 'Bulk 4170'), (4172, 'Bulk 4172'), (4174, 'Bulk 4174'), (4176, 'Bulk 4176'), (4178, 'Bulk 4178'), (4180, 'Bulk 4180'), (4182, 'Bulk 4182'), (4184, 'Bulk 4184'), (4186, 'Bulk 4186'), (4188, 'Bulk 4188'), (4190, 'Bulk 4190'), (4192, 'Bulk 4192'), (4194, 'Bulk 4194'), (4196, 'Bulk 4196'), (4198, 'Bulk 4198'), (4200, 'Bulk 4200')
+INSERT INTO bulk VALUES (-1, 'Before The First Leaf'), (2016123412, 'After The Last Leaf')
+SELECT COUNT(*) FROM bulk
+SELECT COUNT(*) FROM bulk WHERE key >= 4000 AND key <= 4200
+SELECT * FROM bulk WHERE key > 4096 AND key < 4104
+SELECT key FROM bulk WHERE key < 3
+SELECT key FROM bulk WHERE key > 2016123410
+SELECT key FROM bulk WHERE key > 4190 AND key < 4210 ORDER BY key DESC
+
+SELECT * FROM medium WHERE key = 4240 OR key = 489 OR key = 0 OR key = 489 OR key = 99999 OR key = -5
+SELECT COUNT(*) FROM large WHERE key = 4506 OR key = 4515 OR key = 4506 OR key = 2147483647
+SELECT * FROM sorted WHERE key = 4515 OR key = 40 OR key = 40 OR value = 'Seconds'